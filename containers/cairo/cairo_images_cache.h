@@ -1,9 +1,15 @@
 #ifndef LITEHTML_CAIRO_IMAGES_CACHE_H
 #define LITEHTML_CAIRO_IMAGES_CACHE_H
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <list>
 #include <mutex>
-#include <map>
 #include <string>
+#include <unordered_map>
+#include <vector>
 #include <cairo.h>
 
 class cairo_surface_wrapper
@@ -44,47 +50,304 @@ public:
 		}
 	}
 	cairo_surface_t* get() { return cairo_surface_reference(surface); }
+	explicit operator bool() const { return surface != nullptr; }
 };
 
+/// Cache of the decoded images keyed by URL.
+/// The cache is limited by the size of the image data: the least recently used images are removed when the
+/// limit is exceeded. The images pinned by an owner (usually the container of a document) are never removed
+/// until the owner unpins them. The URLs are split between several shards with own locks, so the cache can be
+/// used by many threads. The limit is global: the eviction removes the least recently used image of all shards.
 class cairo_images_cache
 {
-	std::mutex m_mutex;
-	std::map<std::string, cairo_surface_wrapper> m_images;
 public:
-	void add_image(const std::string& url, cairo_surface_t* image)
+	struct statistics
 	{
-		std::unique_lock<std::mutex> lock(m_mutex);
-		m_images[url] = cairo_surface_wrapper(image);
+		uint64_t	hits = 0;
+		uint64_t	misses = 0;
+		uint64_t	evictions = 0;
+		size_t		images = 0;
+		size_t		bytes = 0;
+	};
+
+private:
+	struct entry
+	{
+		std::string					url;
+		cairo_surface_wrapper		surface;
+		size_t						size = 0;
+		uint64_t					last_used = 0;
+		std::vector<const void*>	pins;
+		std::vector<const void*>	loaders;	// the owners loading the image, see reserve()
+	};
+
+	struct shard
+	{
+		std::mutex											mutex;
+		std::list<entry>									lru;	// the most recently used first
+		std::unordered_map<std::string, std::list<entry>::iterator>	index;
+		uint64_t											hits = 0;
+		uint64_t											misses = 0;
+		uint64_t											evictions = 0;
+	};
+
+	static constexpr size_t shards_count = 16;
+
+	std::array<shard, shards_count>	m_shards;
+	size_t							m_max_bytes;
+	std::atomic<size_t>				m_bytes {0};
+	std::atomic<uint64_t>			m_clock {0};	// last_used of the entries
+	std::mutex						m_evict_mutex;
+
+public:
+	/// max_bytes is the limit of the images data size, 0 means no limit
+	explicit cairo_images_cache(size_t max_bytes = 256 * 1024 * 1024) :
+		m_max_bytes(max_bytes)
+	{
+	}
+
+	cairo_images_cache(const cairo_images_cache&) = delete;
+	cairo_images_cache& operator=(const cairo_images_cache&) = delete;
+
+	/// Adds the image into the cache. add_image doesn't increase reference of the image.
+	/// If pin_owner is not null the image is pinned by it, see pin().
+	void add_image(const std::string& url, cairo_surface_t* image, const void* pin_owner = nullptr)
+	{
+		{
+			shard& sh = get_shard(url);
+			std::unique_lock<std::mutex> lock(sh.mutex);
+			entry& item = find_or_create(sh, url);
+			m_bytes -= item.size;
+			item.surface = cairo_surface_wrapper(image);
+			item.size = surface_size(image);
+			item.loaders.clear();
+			m_bytes += item.size;
+			if(pin_owner)
+			{
+				add_pin(item, pin_owner);
+			}
+		}
+		evict(&url);
 	}
 
-	cairo_surface_t* get_image(const std::string& url)
+	/// Returns the new reference to the image or nullptr if the image is not loaded.
+	/// If pin_owner is not null the loaded image is pinned by it under the same lock, see pin().
+	cairo_surface_t* get_image(const std::string& url, const void* pin_owner = nullptr)
 	{
-		std::unique_lock<std::mutex> lock(m_mutex);
-		auto iter = m_images.find(url);
-		if(iter != m_images.end())
+		shard& sh = get_shard(url);
+		std::unique_lock<std::mutex> lock(sh.mutex);
+		auto iter = sh.index.find(url);
+		if(iter != sh.index.end())
 		{
-			return iter->second.get();
+			cairo_surface_t* image = iter->second->surface.get();
+			if(image)
+			{
+				sh.hits++;
+				touch(sh, iter->second);
+				if(pin_owner)
+				{
+					add_pin(*iter->second, pin_owner);
+				}
+				return image;
+			}
 		}
+		sh.misses++;
 		return nullptr;
 	}
 
-	bool reserve(const std::string& url)
+	/// Pins the image by the owner and creates the empty record for it if it doesn't exist. The check and the pin
+	/// are done under one lock, so the image can't be removed between them. Returns true if the image is not loaded
+	/// and the owner doesn't load it yet: the caller has to load it and then call add_image() or cancel(). Other
+	/// owners reserving the image meanwhile load it too, each of them is notified by its own loading.
+	bool reserve(const std::string& url, const void* owner)
 	{
-		std::unique_lock<std::mutex> lock(m_mutex);
-		auto iter = m_images.find(url);
-		if (iter == m_images.end())
+		shard& sh = get_shard(url);
+		std::unique_lock<std::mutex> lock(sh.mutex);
+		entry& item = find_or_create(sh, url);
+		add_pin(item, owner);
+		if(item.surface || std::find(item.loaders.begin(), item.loaders.end(), owner) != item.loaders.end())
 		{
-			m_images[url] = cairo_surface_wrapper();
-			return true;
+			return false;
+		}
+		item.loaders.push_back(owner);
+		return true;
+	}
+
+	/// The owner failed to load the image reserved by reserve(). The empty record is removed when nobody else
+	/// loads the image, so the next reserve() loads it again.
+	void cancel(const std::string& url, const void* owner)
+	{
+		shard& sh = get_shard(url);
+		std::unique_lock<std::mutex> lock(sh.mutex);
+		auto iter = sh.index.find(url);
+		if(iter != sh.index.end())
+		{
+			entry& item = *iter->second;
+			item.loaders.erase(std::remove(item.loaders.begin(), item.loaders.end(), owner), item.loaders.end());
+			if(!item.surface && item.loaders.empty())
+			{
+				sh.lru.erase(iter->second);
+				sh.index.erase(iter);
+			}
 		}
-		return false;
 	}
 
 	bool exists(const std::string& url)
 	{
-		std::unique_lock<std::mutex> lock(m_mutex);
-		auto iter = m_images.find(url);
-		return iter != m_images.end();
+		shard& sh = get_shard(url);
+		std::unique_lock<std::mutex> lock(sh.mutex);
+		return sh.index.find(url) != sh.index.end();
+	}
+
+	/// Prevents removing of the image until unpin(owner) is called. Returns false if the image is not in the cache.
+	bool pin(const std::string& url, const void* owner)
+	{
+		shard& sh = get_shard(url);
+		std::unique_lock<std::mutex> lock(sh.mutex);
+		auto iter = sh.index.find(url);
+		if(iter == sh.index.end())
+		{
+			return false;
+		}
+		add_pin(*iter->second, owner);
+		return true;
+	}
+
+	/// Removes all pins of the owner. The unpinned images can be removed if the cache exceeds the limit.
+	/// The empty records that only the owner was loading are removed, see cancel().
+	void unpin(const void* owner)
+	{
+		for(auto& sh : m_shards)
+		{
+			std::unique_lock<std::mutex> lock(sh.mutex);
+			for(auto iter = sh.lru.begin(); iter != sh.lru.end();)
+			{
+				iter->pins.erase(std::remove(iter->pins.begin(), iter->pins.end(), owner), iter->pins.end());
+				iter->loaders.erase(std::remove(iter->loaders.begin(), iter->loaders.end(), owner), iter->loaders.end());
+				if(!iter->surface && iter->loaders.empty())
+				{
+					sh.index.erase(iter->url);
+					iter = sh.lru.erase(iter);
+				} else
+				{
+					++iter;
+				}
+			}
+		}
+		evict(nullptr);
+	}
+
+	statistics get_statistics()
+	{
+		statistics ret;
+		for(auto& sh : m_shards)
+		{
+			std::unique_lock<std::mutex> lock(sh.mutex);
+			ret.hits		+= sh.hits;
+			ret.misses		+= sh.misses;
+			ret.evictions	+= sh.evictions;
+			ret.images		+= sh.index.size();
+		}
+		ret.bytes = m_bytes;
+		return ret;
+	}
+
+private:
+	shard& get_shard(const std::string& url)
+	{
+		return m_shards[std::hash<std::string>()(url) % shards_count];
+	}
+
+	static size_t surface_size(cairo_surface_t* image)
+	{
+		if(image && cairo_surface_get_type(image) == CAIRO_SURFACE_TYPE_IMAGE)
+		{
+			return (size_t) cairo_image_surface_get_stride(image) * (size_t) cairo_image_surface_get_height(image);
+		}
+		return 0;
+	}
+
+	static void add_pin(entry& item, const void* owner)
+	{
+		if(std::find(item.pins.begin(), item.pins.end(), owner) == item.pins.end())
+		{
+			item.pins.push_back(owner);
+		}
+	}
+
+	// Moves the entry to the front of the shard LRU list. The shard must be locked.
+	void touch(shard& sh, std::list<entry>::iterator iter)
+	{
+		sh.lru.splice(sh.lru.begin(), sh.lru, iter);
+		iter->last_used = ++m_clock;
+	}
+
+	entry& find_or_create(shard& sh, const std::string& url)
+	{
+		auto iter = sh.index.find(url);
+		if(iter == sh.index.end())
+		{
+			sh.lru.emplace_front();
+			sh.lru.front().url = url;
+			iter = sh.index.emplace(url, sh.lru.begin()).first;
+		}
+		touch(sh, iter->second);
+		return *iter->second;
+	}
+
+	// The least recently used image of the shard that can be removed: not pinned, not the empty record being
+	// loaded and not the keep image. The shard must be locked.
+	static std::list<entry>::iterator find_evictable(shard& sh, const std::string* keep)
+	{
+		for(auto iter = sh.lru.rbegin(); iter != sh.lru.rend(); ++iter)
+		{
+			if(iter->pins.empty() && iter->size && (!keep || iter->url != *keep))
+			{
+				return std::prev(iter.base());
+			}
+		}
+		return sh.lru.end();
+	}
+
+	// Removes the least recently used images of all shards until the cache fits the limit. The image being
+	// added (keep), the pinned images and the empty records being loaded are kept. The shards are locked one by one.
+	void evict(const std::string* keep)
+	{
+		if(!m_max_bytes || m_bytes <= m_max_bytes)
+		{
+			return;
+		}
+		std::unique_lock<std::mutex> evict_lock(m_evict_mutex);
+		while(m_bytes > m_max_bytes)
+		{
+			shard* oldest = nullptr;
+			uint64_t oldest_time = 0;
+			for(auto& sh : m_shards)
+			{
+				std::unique_lock<std::mutex> lock(sh.mutex);
+				auto iter = find_evictable(sh, keep);
+				if(iter != sh.lru.end() && (!oldest || iter->last_used < oldest_time))
+				{
+					oldest = &sh;
+					oldest_time = iter->last_used;
+				}
+			}
+			if(!oldest)
+			{
+				break;
+			}
+
+			// The shard could be changed after it was checked, then its oldest image is removed anyway
+			std::unique_lock<std::mutex> lock(oldest->mutex);
+			auto iter = find_evictable(*oldest, keep);
+			if(iter != oldest->lru.end())
+			{
+				m_bytes -= iter->size;
+				oldest->index.erase(iter->url);
+				oldest->lru.erase(iter);
+				oldest->evictions++;
+			}
+		}
 	}
 };
 
@@ -2,6 +2,7 @@
 #include "cairo_borders.h"
 #include "conic_gradient.h"
 #include "litehtml/html.h"
+#include "litehtml/thread_pool.h"
 #include <cmath>
 
 #ifndef M_PI
@@ -467,26 +468,138 @@ void container_cairo::transform_text(litehtml::string& /*text*/, litehtml::text_
 
 void container_cairo::set_clip(const litehtml::position& pos, const litehtml::border_radiuses& bdr_radius )
 {
-	m_clips.emplace_back(pos, bdr_radius);
+	clips().emplace_back(pos, bdr_radius);
 }
 
 void container_cairo::del_clip()
 {
-	if(!m_clips.empty())
+	auto& clip_boxes = clips();
+	if(!clip_boxes.empty())
 	{
-		m_clips.pop_back();
+		clip_boxes.pop_back();
 	}
 }
 
 void container_cairo::apply_clip(cairo_t* cr )
 {
-	for(const auto& clip_box : m_clips)
+	for(const auto& clip_box : clips())
 	{
 		rounded_rectangle(cr, clip_box.box, clip_box.radius);
 		cairo_clip(cr);
 	}
 }
 
+namespace
+{
+	// Clipping of the band drawn by the current thread, see container_cairo::draw_tiled
+	thread_local cairo_clip_box::vector* t_band_clips = nullptr;
+
+	struct band_clips_scope
+	{
+		explicit band_clips_scope(cairo_clip_box::vector* clips) { t_band_clips = clips; }
+		~band_clips_scope() { t_band_clips = nullptr; }
+	};
+}
+
+cairo_clip_box::vector& container_cairo::clips()
+{
+	return t_band_clips ? *t_band_clips : m_clips;
+}
+
+void container_cairo::draw_tiled(const std::shared_ptr<litehtml::document>& doc, cairo_t* cr, litehtml::pixel_t x, litehtml::pixel_t y, const litehtml::position& clip, litehtml::thread_pool* pool)
+{
+	cairo_surface_t* target = cairo_get_target(cr);
+	cairo_matrix_t matrix;
+	cairo_get_matrix(cr, &matrix);
+
+	double offset_x, offset_y;
+	double scale_x, scale_y;
+	cairo_surface_get_device_offset(target, &offset_x, &offset_y);
+	cairo_surface_get_device_scale(target, &scale_x, &scale_y);
+
+	bool can_split = pool && pool->threads_count() > 0 &&
+		cairo_surface_get_type(target) == CAIRO_SURFACE_TYPE_IMAGE &&
+		(cairo_image_surface_get_format(target) == CAIRO_FORMAT_ARGB32 || cairo_image_surface_get_format(target) == CAIRO_FORMAT_RGB24) &&
+		matrix.xy == 0 && matrix.yx == 0 &&
+		offset_x == 0 && offset_y == 0 && scale_x == 1 && scale_y == 1;
+	if(!can_split)
+	{
+		doc->draw((litehtml::uint_ptr) cr, x, y, &clip);
+		return;
+	}
+
+	// Device rectangle to draw: the clip inside the clipping of cr and the surface
+	double x1 = clip.left(), y1 = clip.top(), x2 = clip.right(), y2 = clip.bottom();
+	cairo_user_to_device(cr, &x1, &y1);
+	cairo_user_to_device(cr, &x2, &y2);
+	double cx1, cy1, cx2, cy2;
+	cairo_clip_extents(cr, &cx1, &cy1, &cx2, &cy2);
+	cairo_user_to_device(cr, &cx1, &cy1);
+	cairo_user_to_device(cr, &cx2, &cy2);
+	int left	= std::max({0, (int) std::floor(std::min(x1, x2)), (int) std::floor(std::min(cx1, cx2))});
+	int top		= std::max({0, (int) std::floor(std::min(y1, y2)), (int) std::floor(std::min(cy1, cy2))});
+	int right	= std::min({cairo_image_surface_get_width(target), (int) std::ceil(std::max(x1, x2)), (int) std::ceil(std::max(cx1, cx2))});
+	int bottom	= std::min({cairo_image_surface_get_height(target), (int) std::ceil(std::max(y1, y2)), (int) std::ceil(std::max(cy1, cy2))});
+	if(right <= left || bottom <= top)
+	{
+		return;
+	}
+
+	// Layout and recording of the display list are done here, the bands only replay it
+	doc->ensure_layout(clip.bottom() - y);
+	const litehtml::display_list& list = doc->get_display_list();
+
+	struct band
+	{
+		int					top;
+		int					bottom;
+		litehtml::position	clip;	// user space
+	};
+	const int min_band_height = 32;
+	int bands_count = std::max(1, std::min((bottom - top) / min_band_height, (pool->threads_count() + 1) * 4));
+	std::vector<band> bands(bands_count);
+	for(int i = 0; i < bands_count; i++)
+	{
+		auto& b = bands[i];
+		b.top		= top + (bottom - top) * i / bands_count;
+		b.bottom	= top + (bottom - top) * (i + 1) / bands_count;
+
+		double ux1 = left, uy1 = b.top, ux2 = right, uy2 = b.bottom;
+		cairo_device_to_user(cr, &ux1, &uy1);
+		cairo_device_to_user(cr, &ux2, &uy2);
+		b.clip.x		= (litehtml::pixel_t) std::floor(std::min(ux1, ux2));
+		b.clip.y		= (litehtml::pixel_t) std::floor(std::min(uy1, uy2));
+		b.clip.width	= (litehtml::pixel_t) std::ceil(std::max(ux1, ux2)) - b.clip.x;
+		b.clip.height	= (litehtml::pixel_t) std::ceil(std::max(uy1, uy2)) - b.clip.y;
+	}
+
+	cairo_surface_flush(target);
+	unsigned char* data		= cairo_image_surface_get_data(target);
+	int stride				= cairo_image_surface_get_stride(target);
+	cairo_format_t format	= cairo_image_surface_get_format(target);
+
+	pool->parallel_for(bands.size(), [&](size_t idx)
+		{
+			const auto& b = bands[idx];
+			// The band surface shares the memory of the target surface
+			cairo_surface_t* surface = cairo_image_surface_create_for_data(data + b.top * stride + left * 4, format, right - left, b.bottom - b.top, stride);
+			cairo_t* band_cr = cairo_create(surface);
+			cairo_translate(band_cr, -left, -b.top);
+			cairo_transform(band_cr, &matrix);
+
+			cairo_clip_box::vector band_clips;
+			{
+				band_clips_scope scope(&band_clips);
+				list.replay(this, (litehtml::uint_ptr) band_cr, x, y, &b.clip);
+			}
+
+			cairo_destroy(band_cr);
+			cairo_surface_destroy(surface);
+		});
+
+	cairo_surface_mark_dirty_rectangle(target, left, top, right - left, bottom - top);
+}
+
 void container_cairo::draw_ellipse(cairo_t* cr, litehtml::pixel_t x, litehtml::pixel_t y, litehtml::pixel_t width, litehtml::pixel_t height, const litehtml::web_color& color, litehtml::pixel_t line_width )
 {
 	if(!cr || width == 0 || height == 0) return;
@@ -6,6 +6,11 @@
 #include <cairo.h>
 #include <vector>
 
+namespace litehtml
+{
+	class thread_pool;
+}
+
 struct cairo_clip_box
 {
 	typedef std::vector<cairo_clip_box> vector;
@@ -62,6 +67,12 @@ public:
 	void set_clip(const litehtml::position& pos, const litehtml::border_radiuses& bdr_radius) override;
 	void del_clip() override;
 
+	// Draws the document like document::draw, but splits the drawn area into horizontal bands and draws them
+	// in parallel directly into the memory of the image surface of cr. Falls back to document::draw if cr
+	// doesn't draw into an image surface or has rotation in the transformation.
+	// get_image() and the drawing functions are called concurrently in this mode.
+	void draw_tiled(const std::shared_ptr<litehtml::document>& doc, cairo_t* cr, litehtml::pixel_t x, litehtml::pixel_t y, const litehtml::position& clip, litehtml::thread_pool* pool);
+
 	virtual void make_url( const char* url, const char* basepath, litehtml::string& out );
 	virtual cairo_surface_t* get_image(const std::string& url) = 0;
 	virtual double get_screen_dpi() const = 0;
@@ -77,6 +88,7 @@ protected:
 
 	void clip_background_layer(cairo_t* cr, const litehtml::background_layer& layer);
 	void apply_clip(cairo_t* cr);
+	cairo_clip_box::vector& clips();
 	static void set_color(cairo_t* cr, const litehtml::web_color& color)
 	{
 		cairo_set_source_rgba(cr,
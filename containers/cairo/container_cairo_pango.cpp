@@ -26,6 +26,7 @@ container_cairo_pango::container_cairo_pango()
 
 container_cairo_pango::~container_cairo_pango()
 {
+	litehtml::font_registry::global().release(this);
 	clear_images();
 	cairo_surface_destroy(m_temp_surface);
 	cairo_destroy(m_temp_cr);
@@ -170,6 +171,12 @@ litehtml::uint_ptr container_cairo_pango::create_font(const litehtml::font_descr
 	return (litehtml::uint_ptr) ret;
 }
 
+const void* container_cairo_pango::get_font_backend() const
+{
+	static const char backend = 0;
+	return &backend;
+}
+
 void container_cairo_pango::delete_font(litehtml::uint_ptr hFont)
 {
 	auto* fnt = (cairo_font*) hFont;
@@ -402,12 +409,8 @@ void container_cairo_pango::draw_text(litehtml::uint_ptr hdc, const char *text,
 	pango_cairo_update_layout (cr, layout);
 	pango_cairo_show_layout (cr, layout);
 
-	litehtml::pixel_t tw = 0;
-
-	if(fnt->underline || fnt->strikeout || fnt->overline)
-	{
-		tw = text_width(text, hFont);
-	}
+	// Measured with the layout of cr: text_width() uses m_temp_cr, which is shared by the parallel bands
+	litehtml::pixel_t tw = logical_rect.width;
 
 	if(!fnt->decoration_color.is_current_color)
 	{
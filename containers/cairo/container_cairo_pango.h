@@ -39,6 +39,9 @@ public:
 	void delete_font(litehtml::uint_ptr hFont) override;
 	litehtml::pixel_t text_width(const char* text, litehtml::uint_ptr hFont) override;
 	void draw_text(litehtml::uint_ptr hdc, const char* text, litehtml::uint_ptr hFont, litehtml::web_color color, const litehtml::position& pos) override;
+	// The pango fonts don't depend on the container, so all pango containers share them
+	litehtml::font_registry* get_font_registry() override { return &litehtml::font_registry::global(); }
+	const void* get_font_backend() const override;
 
 	virtual cairo_font_options_t* get_font_options() { return nullptr; }
 };
@@ -7,6 +7,7 @@
 #include <sstream>
 #include <fstream>
 #include "cairo_images_cache.h"
+#include "litehtml/thread_pool.h"
 
 namespace fs = std::filesystem;
 
@@ -65,12 +66,18 @@ namespace html2png
 	{
 		std::string m_base_path;
 		converter* m_converter;
-		cairo_images_cache m_images;
+		cairo_images_cache& m_images;
 	public:
-		explicit container(const std::string& base_path, converter* cvt) : m_base_path(base_path), m_converter(cvt)
+		explicit container(const std::string& base_path, converter* cvt) : m_base_path(base_path), m_converter(cvt), m_images(cvt->get_images_cache())
 		{
 		}
 
+		~container() override
+		{
+			// The images used by the document can be removed from the cache now
+			m_images.unpin(this);
+		}
+
 		void load_image([[maybe_unused]] const char *src, [[maybe_unused]] const char *baseurl, [[maybe_unused]] bool redraw_on_ready) override {}
 		void set_caption([[maybe_unused]] const char *caption) override {}
 
@@ -97,7 +104,7 @@ namespace html2png
 			if(url.empty())
 				return nullptr;
 
-			cairo_surface_t* image_surface = m_images.get_image(url);
+			cairo_surface_t* image_surface = m_images.get_image(url, this);
 
 			if(!image_surface)
 			{
@@ -120,7 +127,7 @@ namespace html2png
 						gdk_cairo_set_source_pixbuf(cr, pixbuf, 0, 0);
 						cairo_paint(cr);
 						cairo_destroy(cr);
-						m_images.add_image(url, image_surface);
+						m_images.add_image(url, image_surface, this);
 						// add_image doesn't increase reference. We must do it manually
 						image_surface = cairo_surface_reference(image_surface);
 					}
@@ -188,6 +195,7 @@ namespace html2png
 		m_screen_height = screen_height;
 		m_dpi = dpi;
 		m_font_options = font_options;
+		m_images = std::make_shared<cairo_images_cache>();
 		if(default_font)
 		{
 			m_default_font = default_font;
@@ -197,6 +205,17 @@ namespace html2png
 		}
 	}
 
+	void converter::set_draw_threads(int threads)
+	{
+		if(threads > 0)
+		{
+			m_draw_pool = std::make_shared<litehtml::thread_pool>(threads);
+		} else
+		{
+			m_draw_pool = nullptr;
+		}
+	}
+
 	GdkPixbuf* converter::to_pixbuf(const std::string &html_file)
 	{
 		html_config cfg(html_file);
@@ -236,7 +255,7 @@ namespace html2png
 
 			// Draw document
 			litehtml::position clip(0, 0, width, height);
-			doc->draw((litehtml::uint_ptr) cr, 0, 0, &clip);
+			cont.draw_tiled(doc, cr, 0, 0, clip, m_draw_pool.get());
 
 			cairo_surface_flush(surface);
 			cairo_destroy(cr);
@@ -2,9 +2,17 @@
 #define LITEHTML_RENDER2PNG_H
 
 #include <string>
+#include <memory>
 #include <cairo.h>
 #include <gdk/gdk.h>
 
+namespace litehtml
+{
+	class thread_pool;
+}
+
+class cairo_images_cache;
+
 namespace html2png
 {
 	class converter
@@ -14,6 +22,8 @@ namespace html2png
 		double m_dpi;
 		const char* m_default_font;
 		cairo_font_options_t* m_font_options;
+		std::shared_ptr<litehtml::thread_pool> m_draw_pool;
+		std::shared_ptr<cairo_images_cache> m_images;
 	public:
 		converter(int screen_width = 800, int screen_height = 600, double dpi = 96, const char* default_font = nullptr, cairo_font_options_t* font_options = nullptr);
 		bool to_png(const std::string &html_file, const std::string &png_file);
@@ -24,6 +34,11 @@ namespace html2png
 		const char* get_default_font() const { return m_default_font; }
 		double get_dpi() const { return m_dpi; }
 		cairo_font_options_t* get_font_options() { return m_font_options; }
+		// Images are shared by all documents converted by this converter
+		cairo_images_cache& get_images_cache() { return *m_images; }
+
+		// Draws the image in horizontal bands using the given number of additional threads. 0 disables it.
+		void set_draw_threads(int threads);
 	};
 
 	enum png_diff_t
@@ -69,24 +69,29 @@ RasterFont* RasterFont::create(string name, int size, int weight)
 	return nullptr;
 }
 
-Bitmap RasterFont::get_glyph(int ch, color color)
+const Bitmap& RasterFont::get_glyph(int ch, color color)
 {
-	if (glyphs[ch].width == 0)
+	auto key = std::make_pair(ch, (uint32_t) color.r << 24 | (uint32_t) color.g << 16 | (uint32_t) color.b << 8 | color.a);
+	// the map nodes are never removed, so the returned reference stays valid after unlocking
+	std::lock_guard<std::mutex> lock(colored_glyphs_mutex);
+	auto it = colored_glyphs.find(key);
+	if (it != colored_glyphs.end())
+		return it->second;
+
+	Bitmap& bmp = colored_glyphs[key];
+	auto glyph = glyphs.find(ch);
+	if (glyph == glyphs.end() || glyph->second.width == 0)
 	{
-		Bitmap bmp(width, (int) height, transparent);
+		bmp = Bitmap(width, (int) height, transparent);
 		bmp.draw_rect(1, 1, width - 2, (int) height - 2, color);
-		return bmp;
-	}
-	else if (color != black)
-	{
-		Bitmap bmp = glyphs[ch];
-		bmp.replace_color(black, color);
-		return bmp;
 	}
 	else
 	{
-		return glyphs[ch];
+		bmp = glyph->second;
+		if (color != black)
+			bmp.replace_color(black, color);
 	}
+	return bmp;
 }
 
 // load .yaff font file in an ad hoc manner (can't parse arbitrary yaff files)
@@ -172,7 +177,11 @@ pixel_t RasterFont::text_width(string text)
 	utf8_to_utf32 utf32(text);
 	int width_ = 0;
 	for (const char32_t* p = utf32; *p; p++)
-		width_ += get_glyph(*p, black).width;
+	{
+		// doesn't change the glyph maps, so text can be measured from the layout threads
+		auto it = glyphs.find(*p);
+		width_ += it != glyphs.end() && it->second.width != 0 ? it->second.width : width;
+	}
 	return (pixel_t) width_;
 }
 
@@ -181,7 +190,7 @@ void RasterFont::draw_text(canvas& cvs, string text, color color, int x, int y)
 	utf8_to_utf32 utf32(text);
 	for (const char32_t* p = utf32; *p; p++)
 	{
-		Bitmap glyph = get_glyph(*p, color);
+		const Bitmap& glyph = get_glyph(*p, color);
 		draw_image(cvs, x, y, glyph);
 		x += glyph.width;
 	}
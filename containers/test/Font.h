@@ -1,9 +1,11 @@
 #include "Bitmap.h"
+#include <mutex>
 
 class Font : public font_metrics
 {
 public:
 	static Font* create(string face, int size, int weight);
+	virtual ~Font() = default;
 	virtual pixel_t text_width(string text) = 0;
 	virtual void draw_text(canvas& canvas, string text, color color, int x, int y) = 0;
 };
@@ -12,13 +14,15 @@ class RasterFont : public Font
 {
 	int width = 0; // for absent glyphs, see get_glyph
 	std::map<int, Bitmap> glyphs;
+	std::map<std::pair<int, uint32_t>, Bitmap> colored_glyphs; // cache of get_glyph
+	std::mutex colored_glyphs_mutex; // the fonts are shared by the documents drawn on different threads
 public:
 	RasterFont(int size, int weight);
 
 	static struct size_name { int size; string name; } installed_fonts[];
 	static RasterFont* create(string face, int size, int weight);
 
-	Bitmap get_glyph(int ch, color color);
+	const Bitmap& get_glyph(int ch, color color);
 	void load(string filename);
 
 	pixel_t text_width(string text) override;
@@ -2360,6 +2360,31 @@ rgba canvas::paint_pixel(
              ( ( brush.repetition & 1 ) &&
                ( point.y < 0.0f || height <= point.y ) ) )
             return rgba( 0.0f, 0.0f, 0.0f, 0.0f );
+        // Unscaled pattern at a whole pixel offset: the filter weights are one
+        // for the pixel itself and zero for its neighbors, so just copy it.
+        if ( inverse.a == 1.0f && inverse.b == 0.0f &&
+             inverse.c == 0.0f && inverse.d == 1.0f &&
+             point.x - 0.5f == floorf( point.x - 0.5f ) &&
+             point.y - 0.5f == floorf( point.y - 0.5f ) )
+        {
+            int pattern_x = static_cast< int >( point.x - 0.5f );
+            int pattern_y = static_cast< int >( point.y - 0.5f );
+            int wrapped_x = pattern_x % brush.width;
+            if ( wrapped_x < 0 )
+                wrapped_x += brush.width;
+            int wrapped_y = pattern_y % brush.height;
+            if ( wrapped_y < 0 )
+                wrapped_y += brush.height;
+            if ( &brush == &image_brush )
+            {
+                wrapped_x = std::min( std::max( pattern_x, 0 ),
+                                      brush.width - 1 );
+                wrapped_y = std::min( std::max( pattern_y, 0 ),
+                                      brush.height - 1 );
+            }
+            return brush.colors[ static_cast< size_t >(
+                wrapped_y * brush.width + wrapped_x ) ];
+        }
         float scale_x = fabsf( inverse.a ) + fabsf( inverse.c );
         float scale_y = fabsf( inverse.b ) + fabsf( inverse.d );
         scale_x = std::max( 1.0f, std::min( scale_x, width * 0.25f ) );
@@ -2665,7 +2690,29 @@ void canvas::render_main(
     float clip_sum = 0.0f;
     size_t path_index = 0;
     size_t clip_index = 0;
-    while ( clip_index < mask.size() )
+    size_t clip_end = mask.size();
+    // The operations keeping the pixels outside of the path don't change the
+    // rows without the path runs, so only the rows of the path are visited.
+    if ( operation & 8 )
+    {
+        if ( runs.empty() )
+            return;
+        pixel_run first = { 0, runs.front().y, 0.0f };
+        pixel_run last = { 0, static_cast< unsigned short >(
+                               runs.back().y + 1 ), 0.0f };
+        clip_index = static_cast< size_t >(
+            std::lower_bound( mask.begin(), mask.end(), first ) -
+            mask.begin() );
+        if ( runs.back().y + 1 < 65536 )
+            clip_end = static_cast< size_t >(
+                std::lower_bound( mask.begin(), mask.end(), last ) -
+                mask.begin() );
+    }
+    // Solid colors don't depend on the pixel position
+    bool solid = brush.type == paint_brush::color;
+    rgba solid_color = solid ? paint_pixel( xy( 0.0f, 0.0f ), brush ) :
+                               rgba( 0.0f, 0.0f, 0.0f, 0.0f );
+    while ( clip_index < clip_end )
     {
         bool which = ( path_index < runs.size() &&
                        runs[ path_index ] < mask[ clip_index ] );
@@ -2679,10 +2726,10 @@ void canvas::render_main(
             for ( ; x < to; ++x )
             {
                 rgba &back = bitmap[ y * size_x + x ];
-                rgba fore = coverage * global_alpha *
+                rgba fore = coverage * global_alpha * ( solid ? solid_color :
                     paint_pixel( xy( static_cast< float >( x ) + 0.5f,
                                      static_cast< float >( y ) + 0.5f ),
-                                 brush );
+                                 brush ) );
                 float mix_fore = operation & 1 ? back.a : 0.0f;
                 if ( operation & 2 )
                     mix_fore = 1.0f - mix_fore;
@@ -2999,6 +3046,7 @@ void canvas::set_pattern(
     paint_brush &brush = type == fill_style ? fill_brush : stroke_brush;
     brush.type = paint_brush::pattern;
     brush.colors.clear();
+    brush.colors.reserve( static_cast< size_t >( width * height ) );
     for ( int y = 0; y < height; ++y )
         for ( int x = 0; x < width; ++x )
         {
@@ -113,6 +113,17 @@ uint_ptr test_container::create_font(const font_description& descr, const docume
 	return (uint_ptr)font;
 }
 
+void test_container::delete_font(uint_ptr hFont)
+{
+	delete (Font*)hFont;
+}
+
+const void* test_container::get_font_backend() const
+{
+	static const char backend = 0;
+	return &backend;
+}
+
 pixel_t test_container::text_width(const char* text, uint_ptr hFont)
 {
 	Font* font = (Font*)hFont;
@@ -135,6 +146,21 @@ void test_container::draw_solid_fill(uint_ptr hdc, const background_layer& layer
 	fill_rect(*cvs, layer.border_box, color);
 }
 
+// draws the part (left, top, width, height) of the image, the image is at the whole pixel position x, y
+static void draw_image_part(canvas& cvs, int x, int y, canvas& img, int left, int top, int width, int height)
+{
+	// clip to the canvas, so the canvas doesn't have to clip the image edges
+	int right  = std::min(left + width, cvs.width() - x);
+	int bottom = std::min(top + height, cvs.height() - y);
+	left = std::max(left, -x);
+	top  = std::max(top, -y);
+	if (left >= right || top >= bottom) return;
+
+	Bitmap bmp(right - left, bottom - top);
+	img.get_image_data((byte*)bmp.data.data(), bmp.width, bmp.height, bmp.width * 4, left, top);
+	::draw_image(cvs, x + left, y + top, bmp);
+}
+
 void test_container::draw_borders(uint_ptr hdc, const borders& borders, const position& pos, bool /*root*/)
 {
 	canvas img((int) pos.width, (int) pos.height);
@@ -177,7 +203,30 @@ void test_container::draw_borders(uint_ptr hdc, const borders& borders, const po
 	fill_polygon(img, {C, D, d, c}, borders.bottom.color);
 	fill_polygon(img, {D, A, a, d}, borders.left.color);
 
-	::draw_image(*(canvas*)hdc, pos.x, pos.y, img);
+	auto& cvs = *(canvas*)hdc;
+
+	// The area inside the borders is transparent, so only the border strips are drawn if the box is at the
+	// whole pixel position (otherwise the image filter mixes the neighbouring pixels).
+	int w = img.width();
+	int h = img.height();
+	int top    = (int) ceil(top_width);
+	int bottom = (int) floor(height_ - bottom_width);
+	int left   = (int) ceil(left_width);
+	int right  = (int) floor(width_ - right_width);
+	if (pos.x != floor(pos.x) || pos.y != floor(pos.y) || top >= bottom || left >= right)
+	{
+		::draw_image(cvs, pos.x, pos.y, img);
+		return;
+	}
+
+	if (top > 0)
+		draw_image_part(cvs, (int) pos.x, (int) pos.y, img, 0, 0, w, top);
+	if (bottom < h)
+		draw_image_part(cvs, (int) pos.x, (int) pos.y, img, 0, bottom, w, h - bottom);
+	if (left > 0)
+		draw_image_part(cvs, (int) pos.x, (int) pos.y, img, 0, top, left, bottom - top);
+	if (right < w)
+		draw_image_part(cvs, (int) pos.x, (int) pos.y, img, right, top, w - right, bottom - top);
 }
 
 void test_container::draw_list_marker(uint_ptr hdc, const list_marker& marker)
@@ -14,11 +14,12 @@ public:
 	std::map<string, Bitmap> images;
 
 	test_container(int width, int height, string basedir) : width(width), height(height), basedir(basedir) {}
+	~test_container() { font_registry::global().release(this); }
 
 	string make_url(const char* src, const char* baseurl);
 
 	uint_ptr		create_font(const font_description& descr, const document* doc, litehtml::font_metrics* fm) override;
-	void			delete_font(uint_ptr /*hFont*/) override {}
+	void			delete_font(uint_ptr hFont) override;
 	pixel_t			text_width(const char* text, uint_ptr hFont) override;
 	void			draw_text(uint_ptr hdc, const char* text, uint_ptr hFont, web_color color, const position& pos) override;
 	pixel_t			pt_to_px(float pt) const override;
@@ -51,4 +52,7 @@ public:
 	void			set_cursor(const char* /*cursor*/) override {}
 	void			import_css(string& text, const string& url, string& baseurl) override;
 	void			get_viewport(position& client) const override;
+	// The fonts don't depend on the container, so all test containers share them
+	font_registry*	get_font_registry() override { return &font_registry::global(); }
+	const void*		get_font_backend() const override;
 };
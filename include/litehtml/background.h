@@ -88,6 +88,34 @@ namespace litehtml
 		};
 	};
 
+	/// Gradients of the background layers cached by the render item between the draws.
+	/// The gradient is reused while its definition and the origin box are the same, so redrawing the element
+	/// after the style changes doesn't compute the geometry and the color points again.
+	class background_gradients_cache
+	{
+	public:
+		template<class T>
+		struct item
+		{
+			int			idx = 0;
+			gradient	definition;
+			position	origin_box;
+			bool		is_empty = true;	// nothing to draw
+			T			value;
+		};
+
+		vector<item<background_layer::linear_gradient>>	linear;
+		vector<item<background_layer::radial_gradient>>	radial;
+		vector<item<background_layer::conic_gradient>>	conic;
+
+		void clear()
+		{
+			linear.clear();
+			radial.clear();
+			conic.clear();
+		}
+	};
+
 	class background
 	{
 	public:
@@ -112,6 +140,12 @@ namespace litehtml
 		int_vector				m_clip;
 		int_vector				m_origin;
 
+		// the initial value, used by the elements without computed styles
+		static const background empty;
+
+		bool operator==(const background& val) const;
+		size_t hash() const;
+
 		bool is_empty() const
 		{
 			if(m_color.alpha != 0)
@@ -139,7 +173,7 @@ namespace litehtml
 		std::unique_ptr<background_layer::linear_gradient> get_linear_gradient_layer(int idx, const background_layer& layer) const;
 		std::unique_ptr<background_layer::radial_gradient> get_radial_gradient_layer(int idx, const background_layer& layer) const;
 		std::unique_ptr<background_layer::conic_gradient> get_conic_gradient_layer(int idx, const background_layer& layer) const;
-		void draw_layer(uint_ptr hdc, int idx, const background_layer& layer, document_container* container) const;
+		void draw_layer(uint_ptr hdc, int idx, const background_layer& layer, document_container* container, background_gradients_cache* cache = nullptr) const;
 	};
 }
 
@@ -27,6 +27,8 @@ namespace litehtml
 
 		css_border& operator=(const css_border& val) = default;
 
+		bool operator==(const css_border& val) const { return width == val.width && style == val.style && color == val.color; }
+
 		string to_string() const;
 	};
 
@@ -196,6 +198,14 @@ namespace litehtml
 
 		css_border_radius& operator=(const css_border_radius& val) = default;
 
+		bool operator==(const css_border_radius& val) const
+		{
+			return	top_left_x == val.top_left_x && top_left_y == val.top_left_y &&
+					top_right_x == val.top_right_x && top_right_y == val.top_right_y &&
+					bottom_right_x == val.bottom_right_x && bottom_right_y == val.bottom_right_y &&
+					bottom_left_x == val.bottom_left_x && bottom_left_y == val.bottom_left_y;
+		}
+
 		border_radiuses calc_percents(pixel_t width, pixel_t height) const
 		{
 			border_radiuses ret;
@@ -220,6 +230,9 @@ namespace litehtml
 		css_border			bottom;
 		css_border_radius	radius;
 
+		// the initial value, used by the elements without computed styles
+		static const css_borders empty;
+
 		css_borders() = default;
 
 		bool is_visible() const
@@ -237,6 +250,13 @@ namespace litehtml
 		}
 
 		css_borders& operator=(const css_borders& val) = default;
+
+		bool operator==(const css_borders& val) const
+		{
+			return left == val.left && top == val.top && right == val.right && bottom == val.bottom && radius == val.radius;
+		}
+		size_t hash() const;
+
 		string to_string() const
 		{
 			return	"left: " + left.to_string() +
@@ -31,6 +31,9 @@ namespace litehtml
 		css_length();
 		css_length(float val, css_units units = css_units_px);
 		css_length&	operator=(float val);
+		bool		operator==(const css_length& val) const;
+		bool		operator!=(const css_length& val) const { return !(*this == val); }
+		size_t		hash() const;
 
 		bool		is_predefined() const;
 		void		predef(int val);
@@ -71,6 +74,24 @@ namespace litehtml
 		return *this;
 	}
 
+	inline bool css_length::operator==(const css_length& val) const
+	{
+		if(m_is_predefined || val.m_is_predefined)
+		{
+			return m_is_predefined == val.m_is_predefined && m_predef == val.m_predef;
+		}
+		return m_value == val.m_value && m_units == val.m_units;
+	}
+
+	inline size_t css_length::hash() const
+	{
+		if(m_is_predefined)
+		{
+			return (size_t) m_predef;
+		}
+		return hash_combine(std::hash<float>()(m_value), (size_t) m_units);
+	}
+
 	inline bool css_length::is_predefined() const
 	{ 
 		return m_is_predefined;					
@@ -12,16 +12,17 @@ class css_parser
 {
 	css_token_vector m_tokens;
 	int m_index = 0;
+	css_token m_eof;
 
-	css_token next_token();
-	css_token peek_token();
+	css_token& next_token();
+	const css_token& peek_token();
 
 public:
 	css_parser() {}
-	css_parser(const css_token_vector& tokens) : m_tokens(tokens) {}
+	css_parser(css_token_vector tokens) : m_tokens(std::move(tokens)) {}
 
-	static raw_rule::vector parse_stylesheet(const string& input,           bool top_level);
-	static raw_rule::vector parse_stylesheet(const css_token_vector& input, bool top_level);
+	static raw_rule::vector parse_stylesheet(const string& input,     bool top_level);
+	static raw_rule::vector parse_stylesheet(css_token_vector input, bool top_level);
 	raw_rule::vector		consume_list_of_rules(bool top_level);
 	raw_rule::ptr			consume_qualified_rule();
 	raw_rule::ptr			consume_at_rule();
@@ -20,6 +20,8 @@ namespace litehtml
 
 		css_size() = default;
 		css_size(css_length width, css_length height) : width(width), height(height) {}
+
+		bool operator==(const css_size& val) const { return width == val.width && height == val.height; }
 	};
 
 	using size_vector = std::vector<css_size>;
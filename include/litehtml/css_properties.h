@@ -43,7 +43,7 @@ namespace litehtml
 		element_clear			m_clear;
 		css_margins				m_css_margins;
 		css_margins				m_css_padding;
-		css_borders				m_css_borders;
+		const css_borders*		m_css_borders;		// shared by the elements of the document, see document::add_borders()
 		css_length				m_css_width;
 		css_length				m_css_height;
 		css_length				m_css_min_width;
@@ -58,7 +58,7 @@ namespace litehtml
 		list_style_position		m_list_style_position;
 		string					m_list_style_image;
 		string					m_list_style_image_baseurl;
-		background				m_bg;
+		const background*		m_bg;				// shared by the elements of the document, see document::add_background()
 		uint_ptr				m_font;
 		css_length				m_font_size;
 		string					m_font_family;
@@ -91,14 +91,17 @@ namespace litehtml
 		flex_align_content		m_flex_align_content;
 
 		caption_side			m_caption_side;
+		table_layout			m_table_layout;
 
 		int 					m_order;
 
 	private:
 		void compute_font(const html_tag* el, const std::shared_ptr<document>& doc);
+		void compute_borders(const html_tag* el, const std::shared_ptr<document>& doc);
 		void compute_background(const html_tag* el, const std::shared_ptr<document>& doc);
 		void compute_flex(const html_tag* el, const std::shared_ptr<document>& doc);
-		web_color get_color_property(const html_tag* el, string_id name, bool inherited, web_color default_value, uint_ptr member_offset) const;
+		template<class... Offset>
+		web_color get_color_property(const html_tag* el, string_id name, bool inherited, web_color default_value, Offset... member_offset) const;
 		void snap_border_width(css_length& width, const std::shared_ptr<document>& doc);
 
 	public:
@@ -117,7 +120,7 @@ namespace litehtml
 				m_clear(clear_none),
 				m_css_margins(),
 				m_css_padding(),
-				m_css_borders(),
+				m_css_borders(&css_borders::empty),
 				m_css_width(),
 				m_css_height(),
 				m_css_min_width(),
@@ -129,7 +132,7 @@ namespace litehtml
 				m_css_line_height(0),
 				m_list_style_type(list_style_type_none),
 				m_list_style_position(list_style_position_outside),
-				m_bg(),
+				m_bg(&background::empty),
 				m_font(0),
 				m_font_size(0),
 				m_font_metrics(),
@@ -145,11 +148,14 @@ namespace litehtml
 				m_flex_align_items(flex_align_items_stretch),
 				m_flex_align_self(flex_align_items_auto),
 				m_flex_align_content(flex_align_content_stretch),
+				m_table_layout(table_layout_auto),
 				m_order(0)
 		{}
 
 		void compute(const html_tag* el, const std::shared_ptr<document>& doc);
 		std::vector<std::tuple<string, string>> dump_get_attrs();
+		// Returns the bytes of the heap blocks owned by the properties
+		size_t memory_usage() const;
 
 		element_position get_position() const;
 		void set_position(element_position mElPosition);
@@ -194,7 +200,8 @@ namespace litehtml
 		void set_padding(const css_margins &mCssPadding);
 
 		const css_borders &get_borders() const;
-		void set_borders(const css_borders &mCssBorders);
+		// The value must be returned by document::add_borders() of the element document
+		void set_borders(const css_borders* borders);
 
 		const css_length &get_width() const;
 		void set_width(const css_length &mCssWidth);
@@ -236,7 +243,8 @@ namespace litehtml
 		void set_list_style_image_baseurl(const string& url);
 
 		const background &get_bg() const;
-		void set_bg(const background &mBg);
+		// The value must be returned by document::add_background() of the element document
+		void set_bg(const background* bg);
 
 		pixel_t get_font_size() const;
 		void set_font_size(pixel_t mFontSize);
@@ -271,6 +279,9 @@ namespace litehtml
 		caption_side get_caption_side() const;
 		void set_caption_side(caption_side side);
 
+		table_layout get_table_layout() const;
+		void set_table_layout(table_layout layout);
+
 		float get_flex_grow() const;
 		float get_flex_shrink() const;
 		const css_length& get_flex_basis() const;
@@ -436,12 +447,12 @@ namespace litehtml
 
 	inline const css_borders &css_properties::get_borders() const
 	{
-		return m_css_borders;
+		return *m_css_borders;
 	}
 
-	inline void css_properties::set_borders(const css_borders &mCssBorders)
+	inline void css_properties::set_borders(const css_borders* borders)
 	{
-		m_css_borders = mCssBorders;
+		m_css_borders = borders;
 	}
 
 	inline const css_length &css_properties::get_width() const
@@ -562,12 +573,12 @@ namespace litehtml
 
 	inline const background &css_properties::get_bg() const
 	{
-		return m_bg;
+		return *m_bg;
 	}
 
-	inline void css_properties::set_bg(const background &mBg)
+	inline void css_properties::set_bg(const background* bg)
 	{
-		m_bg = mBg;
+		m_bg = bg;
 	}
 
 	inline pixel_t css_properties::get_font_size() const
@@ -703,6 +714,15 @@ namespace litehtml
 		m_caption_side = side;
 	}
 
+	inline table_layout css_properties::get_table_layout() const
+	{
+		return m_table_layout;
+	}
+	inline void css_properties::set_table_layout(table_layout layout)
+	{
+		m_table_layout = layout;
+	}
+
 	inline int css_properties::get_order() const
 	{
 		return m_order;
@@ -256,19 +256,20 @@ namespace litehtml
 
 	//////////////////////////////////////////////////////////////////////////
 
+	// Selector matched by the element. The elements keep them by value in one vector, m_selector is not
+	// reference counted: the selectors are owned by the stylesheets of the document, which outlive the elements.
 	class used_selector
 	{
 	public:
-		typedef std::unique_ptr<used_selector>	ptr;
-		typedef std::vector<used_selector::ptr>	vector;
+		typedef std::vector<used_selector>	vector;
 
-		css_selector::ptr	m_selector;
+		const css_selector*	m_selector;
 		bool				m_used;
 
-		used_selector(const css_selector::ptr& selector, bool used)
+		used_selector(const css_selector* selector, bool used) :
+			m_selector(selector),
+			m_used(used)
 		{
-			m_used		= used;
-			m_selector	= selector;
 		}
 	};
 
@@ -108,6 +108,32 @@ struct css_token
 		}
 	}
 
+	// The component values are moved through the parser, so the nested vectors are not copied
+	css_token(css_token&& token) noexcept : type(token.type), str(std::move(token.str)), repr(std::move(token.repr))
+	{
+		switch (type)
+		{
+		case HASH:
+			hash_type = token.hash_type;
+			break;
+
+		case NUMBER:
+		case PERCENTAGE:
+		case DIMENSION:
+			n = token.n;
+			break;
+
+		case CV_FUNCTION:
+		case CURLY_BLOCK:
+		case ROUND_BLOCK:
+		case SQUARE_BLOCK:
+			new(&value) vector(std::move(token.value));
+			break;
+
+		default:;
+		}
+	}
+
 	css_token& operator=(const css_token& token)
 	{
 		this->~css_token();
@@ -115,6 +141,16 @@ struct css_token
 		return *this;
 	}
 
+	css_token& operator=(css_token&& token) noexcept
+	{
+		if (this != &token)
+		{
+			this->~css_token();
+			new(this) css_token(std::move(token));
+		}
+		return *this;
+	}
+
 	~css_token()
 	{
 		str.~string();
@@ -148,7 +184,10 @@ struct css_token
 		vector<css_token> value; // CV_FUNCTION, XXX_BLOCK
 	};
 
-	string repr; // https://www.w3.org/TR/css-syntax-3/#representation
+	// https://www.w3.org/TR/css-syntax-3/#representation
+	// Empty if it is the same as the one get_repr() builds from the token, which is true for the most of the tokens.
+	// It is kept for the numbers, escapes, single-quoted strings and the whitespace other than a single space.
+	string repr;
 };
 
 using css_token_vector = vector<css_token>;
@@ -0,0 +1,38 @@
+#ifndef LH_DAMAGE_REGION_H
+#define LH_DAMAGE_REGION_H
+
+#include "types.h"
+
+namespace litehtml
+{
+	/// Set of rectangles to repaint.
+	/// The added rectangles are merged while the merged rectangle doesn't cover much more area than the
+	/// source ones (max_overdraw), and the count of rectangles never exceeds max_rects.
+	class damage_region
+	{
+		position::vector	m_rects;
+		int					m_max_rects;
+		float				m_max_overdraw;
+	public:
+		explicit damage_region(int max_rects = 16, float max_overdraw = 1.5f) :
+			m_max_rects(std::max(max_rects, 1)),
+			m_max_overdraw(max_overdraw)
+		{}
+
+		void add(const position& box);
+		void add(const position::vector& boxes);
+		void add(const damage_region& region) { add(region.m_rects); }
+		void clear() { m_rects.clear(); }
+
+		bool empty() const { return m_rects.empty(); }
+		const position::vector& rects() const { return m_rects; }
+		/// Bounding box of all rectangles
+		position bounds() const;
+
+	private:
+		void merge_overlapped(size_t idx);
+		void reduce();
+	};
+}
+
+#endif  // LH_DAMAGE_REGION_H
@@ -0,0 +1,210 @@
+#ifndef LH_DISPLAY_LIST_H
+#define LH_DISPLAY_LIST_H
+
+#include "document_container.h"
+
+namespace litehtml
+{
+	/// Flat list of the drawing operations recorded from the render tree.
+	/// document::draw records it once after the layout and then just replays it. Containers can also read
+	/// the operations directly, for example to batch them.
+	/// Positions are relative to the document origin, or to the viewport for the position:fixed elements.
+	class display_list
+	{
+	public:
+		enum op_type
+		{
+			op_text,
+			op_list_marker,
+			op_image,
+			op_solid_fill,
+			op_linear_gradient,
+			op_radial_gradient,
+			op_conic_gradient,
+			op_borders,
+			op_set_clip,
+			op_del_clip,
+			op_group,			// operations drawn by one element, see begin_group()
+		};
+
+		struct op
+		{
+			op_type		type;
+			int			index;		// index of the operation data in the list of the corresponding type,
+									// index of the first operation after the group for op_group
+			position	box;		// bounding box of the operation
+			bool		fixed;		// box is relative to the viewport
+			bool		no_cull;	// drawn regardless of the clipping rectangle (root element)
+		};
+
+		struct text_op
+		{
+			string		text;
+			uint_ptr	font;
+			web_color	color;
+			position	pos;
+		};
+
+		struct list_marker_op
+		{
+			list_marker	marker;		// marker.baseurl is not stored, see baseurl
+			string		baseurl;
+			bool		has_baseurl;
+		};
+
+		struct image_op
+		{
+			background_layer	layer;
+			string				url;
+			string				base_url;
+		};
+
+		struct solid_fill_op
+		{
+			background_layer	layer;
+			web_color			color;
+		};
+
+		template<class T>
+		struct gradient_op
+		{
+			background_layer	layer;
+			T					gradient;
+		};
+
+		struct borders_op
+		{
+			litehtml::borders	bdr;
+			position			draw_pos;
+			bool				root;
+		};
+
+		struct clip_op
+		{
+			position			pos;
+			border_radiuses		radius;
+		};
+
+	private:
+		std::vector<op>												m_ops;
+		std::vector<text_op>										m_texts;
+		std::vector<list_marker_op>									m_list_markers;
+		std::vector<image_op>										m_images;
+		std::vector<solid_fill_op>									m_solid_fills;
+		std::vector<gradient_op<background_layer::linear_gradient>>	m_linear_gradients;
+		std::vector<gradient_op<background_layer::radial_gradient>>	m_radial_gradients;
+		std::vector<gradient_op<background_layer::conic_gradient>>	m_conic_gradients;
+		std::vector<borders_op>										m_borders;
+		std::vector<clip_op>										m_clips;
+
+		struct open_group
+		{
+			int			op_index;
+			int			clips_count;
+			position	box;
+			bool		has_box;
+			bool		fixed;
+			bool		no_cull;
+		};
+		std::vector<open_group>										m_open_groups;
+
+	public:
+		void clear();
+		bool empty() const { return m_ops.empty(); }
+
+		const std::vector<op>&				ops() const				{ return m_ops; }
+		const text_op&						text(const op& o) const			{ return m_texts[o.index]; }
+		const list_marker_op&				list_marker(const op& o) const	{ return m_list_markers[o.index]; }
+		const image_op&						image(const op& o) const		{ return m_images[o.index]; }
+		const solid_fill_op&				solid_fill(const op& o) const	{ return m_solid_fills[o.index]; }
+		const gradient_op<background_layer::linear_gradient>& linear_gradient(const op& o) const	{ return m_linear_gradients[o.index]; }
+		const gradient_op<background_layer::radial_gradient>& radial_gradient(const op& o) const	{ return m_radial_gradients[o.index]; }
+		const gradient_op<background_layer::conic_gradient>&  conic_gradient(const op& o) const	{ return m_conic_gradients[o.index]; }
+		const borders_op&					borders(const op& o) const		{ return m_borders[o.index]; }
+		const clip_op&						clip(const op& o) const			{ return m_clips[o.index]; }
+
+		void add_text(const char* text, uint_ptr font, web_color color, const position& pos, bool fixed);
+		void add_list_marker(const litehtml::list_marker& marker, bool fixed);
+		void add_image(const background_layer& layer, const string& url, const string& base_url, bool fixed);
+		void add_solid_fill(const background_layer& layer, const web_color& color, bool fixed);
+		void add_linear_gradient(const background_layer& layer, const background_layer::linear_gradient& gradient, bool fixed);
+		void add_radial_gradient(const background_layer& layer, const background_layer::radial_gradient& gradient, bool fixed);
+		void add_conic_gradient(const background_layer& layer, const background_layer::conic_gradient& gradient, bool fixed);
+		void add_borders(const litehtml::borders& bdr, const position& draw_pos, bool root, bool fixed);
+		void add_set_clip(const position& pos, const border_radiuses& radius, bool fixed);
+		void add_del_clip(bool fixed);
+		/// Operations added between begin_group() and end_group() make a group. Its box is the union of the
+		/// operations boxes, so replay() skips the whole group if it is outside the clipping rectangle.
+		/// Groups can be nested and must keep set_clip/del_clip balanced.
+		void begin_group(bool fixed);
+		void end_group();
+
+		/// Sends the operations to the container. x and y shift all but the fixed operations, the operations
+		/// outside the clip rectangle are skipped. Returns the number of the sent operations.
+		size_t replay(document_container* container, uint_ptr hdc, pixel_t x, pixel_t y, const position* clip) const;
+
+	private:
+		void add_op(op_type type, int index, const position& box, bool fixed, bool no_cull = false);
+	};
+
+	/// Container used by the document to record the display list. The drawing calls are stored into the
+	/// list, all other calls are forwarded to the document's container.
+	class display_list_recorder : public document_container
+	{
+		document_container*	m_container;
+		display_list*		m_list;
+		int					m_fixed_depth = 0;
+	public:
+		display_list_recorder(document_container* container, display_list* list) : m_container(container), m_list(list) {}
+
+		document_container* container() const { return m_container; }
+
+		// The elements with position:fixed are drawn between these calls
+		void begin_fixed() { m_fixed_depth++; }
+		void end_fixed() { m_fixed_depth--; }
+		// Drawing of an element subtree is wrapped into these calls
+		void begin_group() { m_list->begin_group(m_fixed_depth > 0); }
+		void end_group() { m_list->end_group(); }
+
+		uint_ptr		create_font(const font_description& descr, const document* doc, font_metrics* fm) override;
+		void			delete_font(uint_ptr hFont) override;
+		pixel_t			text_width(const char* text, uint_ptr hFont) override;
+		void			draw_text(uint_ptr hdc, const char* text, uint_ptr hFont, web_color color, const position& pos) override;
+		pixel_t			pt_to_px(float pt) const override;
+		pixel_t			get_default_font_size() const override;
+		const char*		get_default_font_name() const override;
+		void			draw_list_marker(uint_ptr hdc, const litehtml::list_marker& marker) override;
+		void			load_image(const char* src, const char* baseurl, bool redraw_on_ready) override;
+		void			get_image_size(const char* src, const char* baseurl, litehtml::size& sz) override;
+		void			draw_image(uint_ptr hdc, const background_layer& layer, const std::string& url, const std::string& base_url) override;
+		void			draw_solid_fill(uint_ptr hdc, const background_layer& layer, const web_color& color) override;
+		void			draw_linear_gradient(uint_ptr hdc, const background_layer& layer, const background_layer::linear_gradient& gradient) override;
+		void			draw_radial_gradient(uint_ptr hdc, const background_layer& layer, const background_layer::radial_gradient& gradient) override;
+		void			draw_conic_gradient(uint_ptr hdc, const background_layer& layer, const background_layer::conic_gradient& gradient) override;
+		void			draw_borders(uint_ptr hdc, const litehtml::borders& borders, const position& draw_pos, bool root) override;
+
+		void			set_caption(const char* caption) override;
+		void			set_base_url(const char* base_url) override;
+		void			link(const std::shared_ptr<document>& doc, const element::ptr& el) override;
+		void			on_anchor_click(const char* url, const element::ptr& el) override;
+		bool			on_element_click(const element::ptr& el) override;
+		void			on_mouse_event(const element::ptr& el, mouse_event event) override;
+		void			set_cursor(const char* cursor) override;
+		void			transform_text(string& text, text_transform tt) override;
+		void			import_css(string& text, const string& url, string& baseurl) override;
+		void			set_clip(const position& pos, const border_radiuses& bdr_radius) override;
+		void			del_clip() override;
+		void			get_viewport(position& viewport) const override;
+		element::ptr	create_element(const char* tag_name, const string_map& attributes, const std::shared_ptr<document>& doc) override;
+		void			get_media_features(media_features& media) const override;
+		void			get_language(string& language, string& culture) const override;
+		string			resolve_color(const string& color) const override;
+		void			split_text(const char* text, const std::function<void(const char*)>& on_word, const std::function<void(const char*)>& on_space) override;
+		font_registry*	get_font_registry() override;
+		const void*		get_font_backend() const override;
+		bool			collect_stats() const override;
+		trace_sink*		get_trace_sink() override;
+	};
+}
+
+#endif  // LH_DISPLAY_LIST_H
@@ -6,7 +6,17 @@
 #include "master_css.h"
 #include "encodings.h"
 #include "font_description.h"
+#include "font_registry.h"
+#include "display_list.h"
+#include "damage_region.h"
+#include "trace.h"
+#include "memory_usage.h"
+#include "rule_tree.h"
+#include "background.h"
+#include "borders.h"
+#include <atomic>
 #include <vector>
+#include <unordered_set>
 
 typedef struct GumboInternalOutput GumboOutput;
 
@@ -43,6 +53,31 @@ namespace litehtml
 
 	class html_tag;
 	class render_item;
+	class thread_pool;
+	class formatting_context;
+
+	/// Wall times and counters of the document processing, see document::stats().
+	/// They are collected only if document_container::collect_stats() returns true.
+	struct document_stats
+	{
+		// wall time of the phases in milliseconds
+		double	parse_html_time				= 0;	// HTML parsing and creation of the elements
+		double	parse_css_time				= 0;	// parsing of the master, user and document stylesheets
+		double	apply_stylesheets_time		= 0;	// selectors matching
+		double	compute_styles_time			= 0;
+		double	create_render_items_time	= 0;
+		double	layout_time					= 0;	// render() and ensure_layout()
+		double	draw_time					= 0;	// draw(), including the display list recording
+
+		size_t	selector_match_attempts		= 0;	// selectors tested in apply_stylesheet
+		size_t	selector_matches			= 0;
+		size_t	render_items				= 0;	// render items in the render tree
+		size_t	render_calls				= 0;	// render_item::render() calls for these items
+		size_t	max_render_calls			= 0;	// the most calls for one item, shows how often the items are laid out again
+		size_t	text_width_calls			= 0;
+		size_t	create_font_calls			= 0;	// fonts requested from the container or the font registry
+		size_t	draw_ops					= 0;	// drawing operations sent to the container
+	};
 
 	class document : public std::enable_shared_from_this<document>
 	{
@@ -54,11 +89,16 @@ namespace litehtml
 		std::shared_ptr<render_item>		m_root_render;
 		document_container*					m_container;
 		fonts_map							m_fonts;
+		font_registry*						m_font_registry;
+		trace_sink*							m_trace_sink;
 		css_text::vector					m_css;
 		litehtml::css						m_styles;
 		litehtml::web_color					m_def_color;
 		litehtml::css						m_master_css;
 		litehtml::css						m_user_css;
+		rule_node							m_rule_tree;
+		std::unordered_set<background, hash_method<background>>	m_backgrounds;
+		std::unordered_set<css_borders, hash_method<css_borders>>	m_borders;
 		litehtml::size						m_size;
 		position::vector					m_fixed_boxes;
 		std::shared_ptr<element>			m_over_element;
@@ -70,6 +110,17 @@ namespace litehtml
 		string								m_culture;
 		string								m_text;
 		document_mode						m_mode = no_quirks_mode;
+		std::unique_ptr<thread_pool>		m_layout_pool;
+		pixel_t								m_render_width = 0;
+		pixel_t								m_layout_limit = -1;
+		bool								m_layout_pending = false;
+		std::unique_ptr<formatting_context>	m_layout_ctx;	// the root context of the stopped lazy layout
+		display_list						m_display_list;
+		mutable bool						m_display_list_valid = false;
+		display_list_recorder*				m_recorder = nullptr;
+		bool								m_collect_stats = false;
+		document_stats						m_stats;
+		std::atomic<size_t>					m_text_width_calls {0};	// can be called from the layout threads
 	public:
 		document(document_container* objContainer);
 		virtual ~document();
@@ -77,7 +128,30 @@ namespace litehtml
 		document_container*				container()	{ return m_container; }
 		document_mode					mode() const { return m_mode; }
 		uint_ptr						get_font(const font_description& descr, font_metrics* fm);
+		// Measures the text with the container, the elements call it instead of document_container::text_width
+		pixel_t							text_width(const char* text, uint_ptr font);
 		pixel_t							render(pixel_t max_width, render_type rt = render_all);
+		// Enables parallel layout of independent subtrees (table cells, flex items) using the given number
+		// of additional threads. 0 disables it (default). In this mode document_container::text_width,
+		// get_image_size, get_viewport and pt_to_px can be called concurrently and must be thread-safe.
+		// Does nothing if litehtml is built with LITEHTML_NO_THREADS.
+		void							set_layout_threads(int threads);
+		thread_pool*					layout_pool() const { return m_layout_pool.get(); }
+		// Lays out the document down to the given position if it was rendered with render_lazy. The layout
+		// continues from the blocks where it stopped. Negative value lays out the whole document.
+		// draw() and on_scroll() call it, document_container::on_document_size_changed() reports the new size.
+		void							ensure_layout(pixel_t bottom);
+		bool							layout_pending() const { return m_layout_pending; }
+		// Returns the display list of the document, records it if the document was changed since the last call.
+		const display_list&				get_display_list();
+		// Forces recording of the display list. Call it if the elements were changed without render().
+		void							invalidate_display_list() { m_display_list_valid = false; }
+		// Called by the render tree around drawing of the position:fixed elements
+		void							begin_fixed_draw() { if(m_recorder) m_recorder->begin_fixed(); }
+		void							end_fixed_draw() { if(m_recorder) m_recorder->end_fixed(); }
+		// Called by the render tree around drawing of the element subtrees
+		void							begin_draw_group() { if(m_recorder) m_recorder->begin_group(); }
+		void							end_draw_group() { if(m_recorder) m_recorder->end_group(); }
 		void							draw(uint_ptr hdc, pixel_t x, pixel_t y, const position* clip);
 		web_color						get_def_color()	{ return m_def_color; }
 		void 							cvt_units(css_length& val, const font_metrics& metrics, pixel_t size) const;
@@ -87,12 +161,19 @@ namespace litehtml
 		pixel_t							content_width() const;
 		pixel_t							content_height() const;
 		void							add_stylesheet(const char* str, const char* baseurl, const char* media);
+		// The mouse handlers return true if the elements must be redrawn. The redraw boxes are merged into
+		// a few rectangles, see damage_region.
 		bool							on_mouse_over(pixel_t x, pixel_t y, pixel_t client_x, pixel_t client_y, position::vector& redraw_boxes);
-		std::vector<scroll_values>		on_scroll(pixel_t dx, pixel_t dy, pixel_t x, pixel_t y, pixel_t client_x, pixel_t client_y) const;
+		bool							on_mouse_over(pixel_t x, pixel_t y, pixel_t client_x, pixel_t client_y, damage_region& damage);
+		std::vector<scroll_values>		on_scroll(pixel_t dx, pixel_t dy, pixel_t x, pixel_t y, pixel_t client_x, pixel_t client_y);
 		bool							on_lbutton_down(pixel_t x, pixel_t y, pixel_t client_x, pixel_t client_y, position::vector& redraw_boxes);
+		bool							on_lbutton_down(pixel_t x, pixel_t y, pixel_t client_x, pixel_t client_y, damage_region& damage);
 		bool							on_lbutton_up(pixel_t x, pixel_t y, pixel_t client_x, pixel_t client_y, position::vector& redraw_boxes);
+		bool							on_lbutton_up(pixel_t x, pixel_t y, pixel_t client_x, pixel_t client_y, damage_region& damage);
 		bool							on_button_cancel(position::vector& redraw_boxes);
+		bool							on_button_cancel(damage_region& damage);
 		bool							on_mouse_leave(position::vector& redraw_boxes);
+		bool							on_mouse_leave(damage_region& damage);
 		std::shared_ptr<element>		create_element(const char* tag_name, const string_map& attributes);
 		std::shared_ptr<element>		root();
 		std::shared_ptr<render_item>	root_render();
@@ -107,6 +188,20 @@ namespace litehtml
 
 		void							append_children_from_string(element& parent, const char* str, bool replace_existing);
 		void							dump(dumper& cout);
+		// Returns the phase times and counters collected since the document was created
+		document_stats					stats() const;
+		bool							collect_stats() const { return m_collect_stats; }
+		trace_sink*						get_trace_sink() const { return m_trace_sink; }
+		// Returns the estimated memory used by the elements, render tree, stylesheets and fonts of the document
+		document_memory_usage			memory_usage() const;
+		// Root of the rule tree shared by the elements, see rule_node
+		rule_node*						rule_tree() { return &m_rule_tree; }
+		// Return the copy of the computed value shared by the elements with the equal values, see css_properties.
+		// The values are kept until the document is destroyed.
+		const background*				add_background(background&& bg);
+		const css_borders*				add_borders(css_borders&& borders);
+		// Called by the elements to count the selectors matching, see document_stats
+		void							add_selector_matches(size_t attempts, size_t matches);
 
 		// see doc/document_createFromString.txt
 		static document::ptr  createFromString(
@@ -116,7 +211,9 @@ namespace litehtml
 			const string&        user_styles = "");
 
 	private:
-		uint_ptr	add_font(const font_description& descr, font_metrics* fm);
+		pixel_t		render_layout(pixel_t max_width, render_type rt, pixel_t layout_limit, bool continue_layout = false);
+		bool		update_styles(damage_region& damage);
+		uint_ptr	add_font(const font_key& key, const font_description& descr, font_metrics* fm);
 
 		GumboOutput* parse_html(estring str);
 		void create_node(void* gnode, elements_list& elements, bool parseTextNode, bool process_root);
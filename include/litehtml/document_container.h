@@ -29,6 +29,9 @@ namespace litehtml
 		mouse_event_leave,
 	};
 
+	class font_registry;
+	class trace_sink;
+
 	// call back interface to draw text, images and other elements
 	class document_container
 	{
@@ -62,6 +65,8 @@ namespace litehtml
 		virtual void				set_clip(const litehtml::position& pos, const litehtml::border_radiuses& bdr_radius) = 0;
 		virtual void				del_clip() = 0;
 		virtual void				get_viewport(litehtml::position& viewport) const = 0;
+		// Called when the lazy layout laid out more of the document and its size changed, see render_lazy
+		virtual void				on_document_size_changed(const litehtml::size& /*size*/) {}
 		virtual litehtml::element::ptr	create_element( const char* tag_name,
 														const litehtml::string_map& attributes,
 														const std::shared_ptr<litehtml::document>& doc) = 0;
@@ -70,6 +75,14 @@ namespace litehtml
 		virtual void				get_language(litehtml::string& language, litehtml::string& culture) const = 0;
 		virtual litehtml::string	resolve_color(const litehtml::string& /*color*/) const { return litehtml::string(); }
 		virtual void				split_text(const char* text, const std::function<void(const char*)>& on_word, const std::function<void(const char*)>& on_space);
+		// Registry to share the fonts between the documents (see font_registry), nullptr if each document creates its own fonts
+		virtual litehtml::font_registry*	get_font_registry() { return nullptr; }
+		// Identity of the fonts implementation: the containers returning the same value share the fonts in the font_registry
+		virtual const void*			get_font_backend() const { return this; }
+		// Return true to collect the document statistics, see document::stats()
+		virtual bool				collect_stats() const { return false; }
+		// Receiver of the trace events if litehtml is built with the LITEHTML_TRACE option, see trace_sink
+		virtual litehtml::trace_sink*	get_trace_sink() { return nullptr; }
 
 	protected:
 		virtual ~document_container() = default;
@@ -14,6 +14,7 @@ namespace litehtml
 		bool is_comment() const override;
 		void get_text(string& text) const override;
 		void set_data(const char* data) override;
+		void add_memory_usage(document_memory_usage& usage) const override;
 		std::shared_ptr<render_item> create_render_item(const std::shared_ptr<render_item>& /*parent_ri*/) override
 		{
 			// Comments are not rendered
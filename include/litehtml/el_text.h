@@ -24,6 +24,7 @@ namespace litehtml
 		void draw(uint_ptr hdc, pixel_t x, pixel_t y, const position *clip, const std::shared_ptr<render_item> &ri) override;
 		string				dump_get_name() override;
 		std::vector<std::tuple<string, string>> dump_get_attrs() override;
+		void				add_memory_usage(document_memory_usage& usage) const override;
 	protected:
 		void				get_content_size(size& sz, pixel_t max_width) override;
 	};
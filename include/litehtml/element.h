@@ -14,6 +14,7 @@ namespace litehtml
 	class line_box;
 	class dumper;
 	class render_item;
+	struct document_memory_usage;
 
 	class element : public std::enable_shared_from_this<element>
 	{
@@ -35,6 +36,8 @@ namespace litehtml
 
 		virtual void select_all(const css_selector& selector, elements_list& res);
 		element::ptr _add_before_after(int type, const style& style);
+		// Adds the object size, the members of the element class and the children to the usage
+		void add_element_memory_usage(document_memory_usage& usage, const string& type, size_t object_size) const;
 
 	private:
 		std::map<string_id, int>	m_counter_values;
@@ -128,6 +131,8 @@ namespace litehtml
 		virtual string				dump_get_name();
 		virtual std::vector<std::tuple<string, string>> dump_get_attrs();
 		void						dump(litehtml::dumper& cout);
+		// Adds the memory used by the element and its children, see document::memory_usage()
+		virtual void				add_memory_usage(document_memory_usage& usage) const;
 
 		std::tuple<element::ptr, element::ptr, element::ptr> split_inlines();
 		virtual std::shared_ptr<render_item> create_render_item(const std::shared_ptr<render_item>& parent_ri);
@@ -1,6 +1,7 @@
 #ifndef LITEHTML_FLEX_LINE_H
 #define LITEHTML_FLEX_LINE_H
 
+#include <functional>
 #include "formatting_context.h"
 
 namespace litehtml
@@ -49,6 +50,9 @@ namespace litehtml
 		void distribute_free_space_grow(pixel_t container_main_size);
 		void distribute_free_space_shrink(pixel_t container_main_size);
 		bool fix_min_max_violations();
+		// Calls func for every item. Items with own formatting contexts are rendered in parallel if
+		// the document has the layout thread pool.
+		void render_items(const std::function<void(flex_item* item)>& func);
 	};
 }
 
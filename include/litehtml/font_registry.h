@@ -0,0 +1,164 @@
+#ifndef LH_FONT_REGISTRY_H
+#define LH_FONT_REGISTRY_H
+
+#include "font_description.h"
+#include "string_id.h"
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace litehtml
+{
+	class document;
+	class document_container;
+
+	/// Packed font_description used as the key of the font caches.
+	/// The strings are replaced with their ids, so the key is compared and hashed without allocations.
+	struct font_key
+	{
+		string_id	family						= empty_id;
+		string_id	emphasis_style				= empty_id;
+		float		size						= 0;
+		float		decoration_thickness		= 0;	// value or predefined value of the css_length
+		int			weight						= 0;
+		int			decoration_line				= 0;
+		int			emphasis_position			= 0;
+		uint32_t	decoration_color			= 0;	// packed rgba
+		uint32_t	emphasis_color				= 0;	// packed rgba
+		byte		style						= 0;
+		byte		decoration_style			= 0;
+		byte		decoration_thickness_units	= 0;
+		byte		flags						= 0;	// see enum below
+
+		enum
+		{
+			decoration_thickness_predefined	= 1,
+			decoration_current_color		= 2,
+			emphasis_current_color			= 4,
+		};
+
+		font_key() = default;
+		explicit font_key(const font_description& descr);
+
+		bool operator==(const font_key& key) const;
+		bool operator!=(const font_key& key) const { return !(*this == key); }
+
+		size_t hash() const;
+	};
+
+	struct font_item
+	{
+		uint_ptr		font;
+		font_metrics	metrics;
+	};
+
+	/// Open addressing hash table of the fonts, keyed by font_key.
+	class fonts_map
+	{
+		struct entry
+		{
+			font_key	key;
+			font_item	item;
+			size_t		hash;
+			bool		used;
+		};
+		std::vector<entry>	m_entries;	// the size is zero or a power of two
+		size_t				m_count = 0;
+	public:
+		/// Returns nullptr if the font is not in the map
+		const font_item* find(const font_key& key) const;
+		/// Adds the font, the key must not be in the map
+		void insert(const font_key& key, const font_item& item);
+		void clear();
+
+		size_t size() const { return m_count; }
+		bool empty() const { return m_count == 0; }
+		/// Returns the bytes of the heap blocks owned by the map
+		size_t memory_usage() const { return m_entries.capacity() * sizeof(entry); }
+
+		template<class Func>
+		void for_each(Func func) const
+		{
+			for(const auto& e : m_entries)
+			{
+				if(e.used) func(e.key, e.item);
+			}
+		}
+
+	private:
+		size_t find_slot(const font_key& key, size_t hash) const;
+		void rehash(size_t capacity);
+	};
+
+	/// Thread-safe cache of the fonts shared by the documents, so a new document doesn't create the fonts
+	/// already created for the previous ones.
+	/// Containers opt in by returning the registry from document_container::get_font_registry(). Their
+	/// create_font() must not depend on the document then. The fonts are keyed by the font backend of the
+	/// container (document_container::get_font_backend()), so all containers of one backend share them.
+	/// Every document holds a reference to the fonts it uses, the fonts no document uses are kept for the
+	/// next documents up to max_idle_fonts and then deleted in the least recently used order.
+	/// The methods are virtual, so containers can plug in their own caching policy.
+	class font_registry
+	{
+		struct entry_key
+		{
+			const void*	backend;
+			font_key	key;
+
+			bool operator==(const entry_key& val) const { return backend == val.backend && key == val.key; }
+		};
+		struct entry_key_hash
+		{
+			size_t operator()(const entry_key& val) const { return hash_combine(std::hash<const void*>()(val.backend), val.key.hash()); }
+		};
+		using idle_list = std::list<entry_key>;
+		struct entry
+		{
+			font_item			item;
+			document_container*	owner;		// deletes the font, one of the containers of the backend
+			int					refs;
+			idle_list::iterator	idle_pos;	// position in m_idle if the font is idle
+		};
+
+		std::unordered_map<entry_key, entry, entry_key_hash>	m_fonts;
+		idle_list												m_idle;		// the least recently used first
+		std::vector<std::pair<document_container*, const void*>>	m_containers;	// containers with their backends
+		size_t													m_max_idle_fonts;
+		mutable std::mutex										m_mutex;
+	public:
+		explicit font_registry(size_t max_idle_fonts = 64) : m_max_idle_fonts(max_idle_fonts) {}
+		virtual ~font_registry() = default;
+
+		font_registry(const font_registry&) = delete;
+		font_registry& operator=(const font_registry&) = delete;
+
+		/// Process-wide registry
+		static font_registry& global();
+
+		/// Returns the font for the description created by a container of the same backend and adds a reference
+		/// to it. The font is created by the container on the first call.
+		virtual uint_ptr get_font(document_container* container, const font_key& key, const font_description& descr,
+								  const document* doc, font_metrics* fm);
+		/// Removes the reference added by get_font(). The font becomes idle if it has no references.
+		virtual void release_font(document_container* container, const font_key& key);
+		/// Removes the container from the registry, must be called before the container is destroyed.
+		/// The fonts it created are passed to another container of the same backend, or deleted if there is none.
+		virtual void release(document_container* container);
+
+		/// Sets the number of idle fonts kept in the registry, the least recently used ones are deleted
+		void set_max_idle_fonts(size_t max_idle_fonts);
+
+		/// Number of fonts in the registry
+		size_t size() const;
+		/// Number of fonts not used by any document
+		size_t idle_count() const;
+
+	private:
+		uint_ptr add_ref(entry& e, font_metrics* fm);
+		void evict_idle();
+	};
+}
+
+#endif  // LH_FONT_REGISTRY_H
@@ -2,6 +2,7 @@
 #define LITEHTML_FLOATS_HOLDER_H
 
 #include <list>
+#include <vector>
 #include "media_query.h"
 #include "types.h"
 
@@ -26,6 +27,22 @@ namespace litehtml
 			pixel_t	 container_width = 0; // maximum width on containing block
 		};
 
+		// The state of a block where the lazy layout stopped, the layout continues from it
+		struct stopped_block
+		{
+			const render_item*				el			= nullptr;
+			size_t							child		= 0;	 // index of the child to continue from
+			pixel_t							width		= 0;	 // width of the block the children were laid out in
+			bool							second_pass	= false; // the children were laid out in the second pass
+			pixel_t							child_top	= 0;
+			pixel_t							top_margin	= 0;
+			pixel_t							last_margin	= 0;
+			std::shared_ptr<render_item>	last_margin_el;
+			bool							is_first	= true;
+			int								laid_out	= 0;
+			rendered_width					ret_width;
+		};
+
 	private:
 		std::list<floated_box> m_floats_left;
 		std::list<floated_box> m_floats_right;
@@ -33,9 +50,14 @@ namespace litehtml
 		pixel_pixel_cache m_cache_line_right;
 		pixel_t m_current_top;
 		pixel_t m_current_left;
+		pixel_t m_layout_limit;
+		bool m_layout_stopped;
+		bool m_continuation_broken;
+		std::vector<stopped_block> m_stopped_blocks;	// saved by the stopped layout, from the innermost block
+		std::vector<stopped_block> m_continued_blocks;	// taken by the blocks when the layout continues
 
 	public:
-		formatting_context() : m_current_top(0), m_current_left(0)	{}
+		formatting_context() : m_current_top(0), m_current_left(0), m_layout_limit(-1), m_layout_stopped(false), m_continuation_broken(false)	{}
 
 		void push_position(pixel_t x, pixel_t y)
 		{
@@ -48,6 +70,29 @@ namespace litehtml
 			m_current_top -= y;
 		}
 
+		// The in-flow blocks placed below the layout limit are not laid out. Negative limit means no limit.
+		void set_layout_limit(pixel_t limit) { m_layout_limit = limit; }
+		pixel_t get_layout_limit() const { return m_layout_limit; }
+		bool is_below_layout_limit(pixel_t y) const { return m_layout_limit >= 0 && m_current_top + y > m_layout_limit; }
+		void set_layout_stopped() { m_layout_stopped = true; }
+		bool is_layout_stopped() const { return m_layout_stopped; }
+		// The blocks on the way from the stopped child to the root save their state here
+		void add_stopped_block(stopped_block&& block) { m_stopped_blocks.push_back(std::move(block)); }
+		// A block lays its children out again after the layout stopped in them, e.g. with the new width
+		void restart_layout()
+		{
+			m_layout_stopped = false;
+			m_stopped_blocks.clear();
+		}
+		// Continues the stopped layout with the new limit: the stopped blocks skip their laid out children.
+		// Returns false if the document has to be laid out from the top.
+		bool continue_layout(pixel_t limit);
+		const stopped_block* find_continued_block(const render_item* el) const;
+		bool take_continued_block(const render_item* el, stopped_block& block);
+		// The block can't continue from the saved state, the continued layout is wrong
+		void break_continuation() { m_continuation_broken = true; }
+		bool is_continuation_broken() const { return m_continuation_broken; }
+
 		void add_float(const std::shared_ptr<render_item> &el, pixel_t min_width, int context);
 		void clear_floats(int context);
 		new_position place_to_left(const el_position& el_pos) const;
@@ -114,6 +114,12 @@ namespace litehtml
 			color_stop(web_color color, float angle)       : color(color), angle(angle)          {}
 			color_stop(css_length length)                  : is_color_hint(true), length(length) {}
 			color_stop(float angle)                        : is_color_hint(true), angle(angle)   {}
+
+			bool operator==(const color_stop& val) const
+			{
+				return is_color_hint == val.is_color_hint && color == val.color && color.is_current_color == val.color.is_current_color &&
+					length == val.length && angle == val.angle;
+			}
 		};
 
 		string_id m_type;
@@ -166,6 +172,9 @@ namespace litehtml
 			return m_type == empty_id || m_colors.empty();
 		}
 
+		bool operator==(const gradient& val) const;
+		bool operator!=(const gradient& val) const { return !(*this == val); }
+
 		bool is_linear() const { return m_type == _linear_gradient_ || m_type == _repeating_linear_gradient_; }
 		bool is_radial() const { return m_type == _radial_gradient_ || m_type == _repeating_radial_gradient_; }
 		bool is_conic() const { return m_type == _conic_gradient_ || m_type == _repeating_conic_gradient_; }
@@ -188,6 +197,8 @@ namespace litehtml
 
 		image() : type(type_none) {}
 
+		bool operator==(const image& val) const { return type == val.type && url == val.url && m_gradient == val.m_gradient; }
+
 		bool is_empty() const
 		{
 			switch (type)
@@ -3,6 +3,7 @@
 
 #include "element.h"
 #include "style.h"
+#include "rule_tree.h"
 #include "background.h"
 #include "css_selector.h"
 #include "stylesheet.h"
@@ -25,7 +26,8 @@ namespace litehtml
 		string_id				m_id;
 		string_vector			m_str_classes;
 		vector<string_id>		m_classes;
-		style					m_style;
+		style					m_style;		// declarations added after the last rule, or the own cascaded style, see compute_styles()
+		rule_node*				m_rule_node = nullptr;	// matched rules, owned by the document; nullptr if m_style is the cascaded style
 		string_map				m_attrs;
 		vector<string_id>		m_pseudo_classes;
 
@@ -71,6 +73,9 @@ namespace litehtml
 
 		template<class Type>
 		const Type&			get_property(string_id name, bool inherited, const Type& default_value, uint_ptr css_properties_member_offset) const;
+		// The same for the members of the values shared by the elements, such as css_properties::get_bg()
+		template<class Type, class Value>
+		const Type&			get_property(string_id name, bool inherited, const Type& default_value, const Value& (css_properties::*shared_value)() const, uint_ptr value_member_offset) const;
 		bool				get_custom_property(string_id name, css_token_vector& result) const;
 
 		elements_list&	children();
@@ -103,6 +108,7 @@ namespace litehtml
 		const background*	get_background(bool own_only = false) override;
 
 		string				dump_get_name() override;
+		void				add_memory_usage(document_memory_usage& usage) const override;
 
 	protected:
 		void				draw_list_marker( uint_ptr hdc, const position &pos, const std::shared_ptr<render_item> &ri );
@@ -117,6 +123,10 @@ namespace litehtml
 
 	private:
 		void				handle_counter_properties();
+		// Returns the style cascaded from the rules and the own declarations, valid after compute_styles()
+		const style&		get_style() const { return m_rule_node ? m_rule_node->cascaded() : m_style; }
+		// Returns the value of the property cascaded from the styles added so far
+		const property_value& get_cascaded_property(string_id name) const;
 
 	};
 
@@ -132,7 +142,7 @@ namespace litehtml
 	template<class Type>
 	const Type& html_tag::get_property(string_id name, bool inherited, const Type& default_value, uint_ptr css_properties_member_offset) const
 	{
-		const property_value& value = m_style.get_property(name);
+		const property_value& value = get_style().get_property(name);
 
 		if (value.is<Type>())
 		{
@@ -149,6 +159,26 @@ namespace litehtml
 		return default_value;
 	}
 
+	template<class Type, class Value>
+	const Type& html_tag::get_property(string_id name, bool inherited, const Type& default_value, const Value& (css_properties::*shared_value)() const, uint_ptr value_member_offset) const
+	{
+		const property_value& value = get_style().get_property(name);
+
+		if (value.is<Type>())
+		{
+			return value.get<Type>();
+		}
+		else if (inherited || value.is<inherit>())
+		{
+			if (auto _parent = parent())
+			{
+				return *(Type*)((byte*)&(_parent->css().*shared_value)() + value_member_offset);
+			}
+			return default_value;
+		}
+		return default_value;
+	}
+
 }
 
 #endif  // LH_HTML_TAG_H
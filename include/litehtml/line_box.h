@@ -2,6 +2,7 @@
 #define LH_LINE_BOX_H
 
 #include <memory>
+#include <vector>
 #include "css_properties.h"
 #include "types.h"
 
@@ -27,6 +28,11 @@ namespace litehtml
 		line_context() : calculatedTop(0), top(0), left(0), right(0) {}
     };
 
+	/**
+	 * Compact tagged item of the line box. Items are plain values: text parts and inline boxes refer to
+	 * the render_item position, inline start/continue/end markers keep their own position.
+	 * Items are owned by line_box_storage, so building line boxes does not allocate per item.
+	 */
 	class line_box_item
 	{
 	public:
@@ -37,30 +43,31 @@ namespace litehtml
 			type_inline_continue,
 			type_inline_end
 		};
+		using vector = std::vector<line_box_item>;
 	protected:
-		std::shared_ptr<render_item> m_element;
-		pixel_t m_rendered_min_width = 0;
-		pixel_t m_items_top = 0;
-		pixel_t m_items_bottom = 0;
+		render_item*	m_element;
+		position		m_pos;
+		pixel_t			m_rendered_min_width = 0;
+		pixel_t			m_items_top = 0;
+		pixel_t			m_items_bottom = 0;
+		element_type	m_type;
 	public:
-		explicit line_box_item(const std::shared_ptr<render_item>& element) : m_element(element) {}
-		line_box_item(const line_box_item& el) = default;
-		line_box_item(line_box_item&&) = default;
-		virtual ~line_box_item();
-
-		virtual pixel_t height() const;
-		const std::shared_ptr<render_item>& get_el() const { return m_element; }
-		virtual position& pos();
-		virtual void place_to(pixel_t x, pixel_t y);
-		virtual pixel_t width() const;
-		virtual pixel_t top() const;
-		virtual pixel_t bottom() const;
-		virtual pixel_t right() const;
-		virtual pixel_t left() const;
-		virtual element_type get_type() const	{ return type_text_part; }
-		virtual pixel_t get_rendered_min_width() const	{ return m_rendered_min_width; }
-		virtual void set_rendered_min_width(pixel_t min_width) { m_rendered_min_width = min_width; }
-		virtual void y_shift(pixel_t shift);
+		line_box_item(render_item* element, element_type type);
+
+		render_item* get_el() const { return m_element; }
+		element_type get_type() const	{ return m_type; }
+
+		pixel_t height() const;
+		position& pos();
+		void place_to(pixel_t x, pixel_t y);
+		pixel_t width() const;
+		pixel_t top() const;
+		pixel_t bottom() const;
+		pixel_t right() const;
+		pixel_t left() const;
+		pixel_t get_rendered_min_width() const;
+		void set_rendered_min_width(pixel_t min_width) { m_rendered_min_width = min_width; }
+		void y_shift(pixel_t shift);
 
 		void reset_items_height() { m_items_top = m_items_bottom = 0; }
 		void add_item_height(pixel_t item_top, pixel_t item_bottom)
@@ -72,54 +79,16 @@ namespace litehtml
 		pixel_t get_items_bottom() const { return m_items_bottom; }
 	};
 
-	class lbi_start : public line_box_item
+	/**
+	 * Storage for the items of all line boxes of one inline formatting context.
+	 * Line boxes are built one after another, and only the last one is modified, so each line box owns
+	 * a contiguous range of m_items. All vectors are cleared but not released between renders, so
+	 * rewrapping the content at a new width reuses the same memory.
+	 */
+	class line_box_storage
 	{
-	protected:
-		position m_pos;
-	public:
-		explicit lbi_start(const std::shared_ptr<render_item>& element);
-		~lbi_start() override;
-
-		void place_to(pixel_t x, pixel_t y) override;
-		pixel_t height() const override;
-		pixel_t width() const override;
-		position& pos() override { return m_pos; }
-		pixel_t top() const override;
-		pixel_t bottom() const override;
-		pixel_t right() const override;
-		pixel_t left() const override;
-		element_type get_type() const override	{ return type_inline_start; }
-		pixel_t get_rendered_min_width() const override { return width(); }
-	};
-
-	class lbi_end : public lbi_start
-	{
-	public:
-		explicit lbi_end(const std::shared_ptr<render_item>& element);
-		virtual ~lbi_end() override;
-
-		void place_to(pixel_t x, pixel_t y) override;
-		pixel_t right() const override;
-		pixel_t left() const override;
-		element_type get_type() const override	{ return type_inline_end; }
-		void y_shift(pixel_t) override {}
-	};
+		friend class line_box;
 
-	class lbi_continue : public lbi_start
-	{
-	public:
-		explicit lbi_continue(const std::shared_ptr<render_item>& element);
-		virtual ~lbi_continue() override;
-
-		void place_to(pixel_t x, pixel_t y) override;
-		pixel_t right() const override;
-		pixel_t left() const override;
-		pixel_t width() const override;
-		element_type get_type() const override	{ return type_inline_continue; }
-	};
-
-	class line_box
-    {
 		struct va_context
 		{
 			pixel_t			line_height = 0;
@@ -128,6 +97,30 @@ namespace litehtml
 			line_box_item*	start_lbi = nullptr;
 		};
 
+		struct inline_item_box
+		{
+			render_item* element;
+			position box;
+
+			explicit inline_item_box(render_item* el) : element(el) {}
+		};
+
+		line_box_item::vector			m_items;
+		std::vector<va_context>			m_contexts;
+		std::vector<inline_item_box>	m_inlines;
+	public:
+		void clear() { m_items.clear(); }
+		// Returns the bytes of the heap blocks owned by the storage
+		size_t memory_usage() const
+		{
+			return	m_items.capacity() * sizeof(line_box_item) +
+					m_contexts.capacity() * sizeof(va_context) +
+					m_inlines.capacity() * sizeof(inline_item_box);
+		}
+	};
+
+	class line_box
+    {
         pixel_t					m_top;
         pixel_t					m_left;
         pixel_t					m_right;
@@ -139,10 +132,12 @@ namespace litehtml
         text_align				m_text_align;
 		rendered_width			m_rendered_width;
 
-		std::list< std::unique_ptr<line_box_item> > m_items;
+		line_box_storage*		m_storage;
+		size_t					m_first;	// index of the first item in the storage
+		size_t					m_last;		// index after the last item in the storage
     public:
-		line_box(pixel_t top, pixel_t left, pixel_t right, const css_line_height_t& line_height, const font_metrics& fm,
-				 text_align align) :
+		line_box(line_box_storage* storage, pixel_t top, pixel_t left, pixel_t right, const css_line_height_t& line_height,
+				 const font_metrics& fm, text_align align) :
 			m_top(top),
 			m_left(left),
 			m_right(right),
@@ -151,7 +146,10 @@ namespace litehtml
 			m_default_line_height(line_height),
 			m_font_metrics(fm),
 			m_baseline(0),
-			m_text_align(align)
+			m_text_align(align),
+			m_storage(storage),
+			m_first(storage->m_items.size()),
+			m_last(storage->m_items.size())
 		{
 		}
 
@@ -164,23 +162,36 @@ namespace litehtml
 		pixel_t		   line_right() const { return m_right; }
 		rendered_width get_rendered_width() const { return m_rendered_width; }
 
-		void	add_item(std::unique_ptr<line_box_item> item);
-		bool	can_hold(const std::unique_ptr<line_box_item>& item, white_space ws) const;
+		void	add_item(line_box_item item);
+		bool	can_hold(const line_box_item& item, white_space ws) const;
 		bool	is_empty() const;
 		pixel_t baseline() const;
 		pixel_t top_margin() const;
 		pixel_t bottom_margin() const;
 		void	y_shift(pixel_t shift);
-		
-		std::list< std::unique_ptr<line_box_item> >	finish(bool last_box, const containing_block_context &containing_block_size);
-		std::list< std::unique_ptr<line_box_item> > new_width(pixel_t left, pixel_t right);
-		std::shared_ptr<render_item> 		get_last_text_part() const;
-		std::shared_ptr<render_item> 		get_first_text_part() const;
-		std::list< std::unique_ptr<line_box_item> >& 	items() { return m_items; }
+
+		/**
+		 * Finishes the line box. Items that have to be moved into the next line box are appended to next_items.
+		 */
+		void	finish(bool last_box, const containing_block_context &containing_block_size, line_box_item::vector& next_items);
+		/**
+		 * Changes the line box width. Items that don't fit into the new width are removed from the line box and
+		 * appended to removed_items.
+		 */
+		void	new_width(pixel_t left, pixel_t right, line_box_item::vector& removed_items);
+		/**
+		 * Moves all items out of the line box. Must be called for the last line box only.
+		 */
+		void	release_items(line_box_item::vector& items);
+		render_item* 	get_last_text_part() const;
+		render_item* 	get_first_text_part() const;
 	private:
+		line_box_item* items_begin() const { return m_storage->m_items.data() + m_first; }
+		line_box_item* items_end() const { return m_storage->m_items.data() + m_last; }
+		size_t items_count() const { return m_last - m_first; }
         bool				have_last_space() const;
         bool				is_break_only() const;
-		static pixel_t		calc_va_baseline(const va_context& current, vertical_align va, const font_metrics& new_font, pixel_t top, pixel_t bottom);
+		static pixel_t		calc_va_baseline(const line_box_storage::va_context& current, vertical_align va, const font_metrics& new_font, pixel_t top, pixel_t bottom);
     };
 }
 
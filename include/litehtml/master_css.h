@@ -203,6 +203,14 @@ th {
 	font-weight: bold;
 }
 
+col {
+	display: table-column;
+}
+
+colgroup {
+	display: table-column-group;
+}
+
 table[border] {
 	border-style:solid;
 }
@@ -0,0 +1,127 @@
+#ifndef LH_MEMORY_USAGE_H
+#define LH_MEMORY_USAGE_H
+
+#include "types.h"
+#include <map>
+#include <unordered_set>
+#include <type_traits>
+
+namespace litehtml
+{
+	class background;
+	class image;
+	class style;
+	class css_selector;
+	struct css_token;
+	struct property_value;
+
+	/// Estimated memory used by a document, see document::memory_usage().
+	/// The byte counts are the sizes of the objects and of the heap blocks they own. The overhead of the
+	/// allocator is not included, the overhead of the std::map/std::list nodes and std::make_shared
+	/// control blocks is estimated.
+	struct document_memory_usage
+	{
+		std::map<string, size_t>	element_counts;		// by tag name; "#text", "#space", "#comment" and "#other" for the rest
+
+		size_t	elements				= 0;
+		size_t	element_bytes			= 0;	// element objects, their attributes, classes and texts
+		size_t	css_properties_bytes	= 0;	// computed css_properties of the elements
+		size_t	style_bytes				= 0;	// cascaded styles owned by the elements with the style attribute or var() values
+		size_t	used_styles_bytes		= 0;	// selectors matched by the elements
+		size_t	render_items			= 0;
+		size_t	render_item_bytes		= 0;	// render items without the line boxes
+		size_t	line_boxes				= 0;
+		size_t	line_box_bytes			= 0;	// line boxes and their items
+		size_t	rule_nodes				= 0;
+		size_t	rule_tree_bytes			= 0;	// rule tree nodes and the cascaded styles shared by the elements
+		size_t	shared_values			= 0;
+		size_t	shared_value_bytes		= 0;	// backgrounds and borders shared by the elements, see document::add_background()
+		size_t	selectors				= 0;	// selectors of the master, user and document stylesheets
+		size_t	stylesheet_bytes		= 0;	// the selectors, their declarations and the stylesheet texts
+		size_t	fonts					= 0;
+		size_t	font_bytes				= 0;	// font cache of the document, the fonts are owned by the container
+		size_t	string_ids				= 0;	// strings in the process-wide string_id table
+		size_t	string_id_bytes			= 0;	// the table is shared by all documents
+
+		/// Sum of the bytes used by the document, the shared string_id table is not included
+		size_t	total_bytes() const
+		{
+			return element_bytes + css_properties_bytes + style_bytes + used_styles_bytes + rule_tree_bytes + shared_value_bytes +
+				   render_item_bytes + line_box_bytes + stylesheet_bytes + font_bytes;
+		}
+	};
+
+	// Estimated overhead of the standard containers, used by the memory_usage() functions
+	const size_t tree_node_overhead		= 4 * sizeof(void*);	// color, parent, left and right of the std::map nodes
+	const size_t list_node_overhead		= 2 * sizeof(void*);
+	const size_t hash_node_overhead		= 2 * sizeof(void*);	// next pointer and cached hash of the std::unordered_set nodes
+	const size_t shared_count_size		= 2 * sizeof(void*);	// counters and vtable of the std::make_shared control block
+
+	// The heap_size() functions return the bytes of the heap blocks owned by the value, without sizeof(value)
+	size_t heap_size(const string& str);
+	size_t heap_size(const image& img);
+	size_t heap_size(const background& bg);
+	size_t heap_size(const css_token& token);
+	size_t heap_size(const property_value& val);
+	size_t heap_size(const style& st);
+	/// The selector, its compound selectors and the nested selectors of :not() and :is(), without the style
+	size_t heap_size(const css_selector& selector);
+
+	// The shared objects are counted by their owners
+	template<class T>
+	size_t heap_size(const std::shared_ptr<T>& /*ptr*/)
+	{
+		return 0;
+	}
+
+	template<class T>
+	size_t heap_size(const std::vector<T>& vec)
+	{
+		size_t ret = vec.capacity() * sizeof(T);
+		if constexpr (!std::is_trivially_destructible_v<T>)
+		{
+			for(const auto& item : vec)
+			{
+				ret += heap_size(item);
+			}
+		}
+		return ret;
+	}
+
+	template<class K, class V>
+	size_t heap_size(const std::map<K, V>& map)
+	{
+		size_t ret = map.size() * (tree_node_overhead + sizeof(typename std::map<K, V>::value_type));
+		if constexpr (!std::is_trivially_destructible_v<K> || !std::is_trivially_destructible_v<V>)
+		{
+			for(const auto& item : map)
+			{
+				if constexpr (!std::is_trivially_destructible_v<K>) ret += heap_size(item.first);
+				if constexpr (!std::is_trivially_destructible_v<V>) ret += heap_size(item.second);
+			}
+		}
+		return ret;
+	}
+
+	template<class T>
+	size_t heap_size(const std::list<T>& list)
+	{
+		return list.size() * (list_node_overhead + sizeof(T));
+	}
+
+	template<class T, class H>
+	size_t heap_size(const std::unordered_set<T, H>& set)
+	{
+		size_t ret = set.bucket_count() * sizeof(void*) + set.size() * (hash_node_overhead + sizeof(T));
+		if constexpr (!std::is_trivially_destructible_v<T>)
+		{
+			for(const auto& item : set)
+			{
+				ret += heap_size(item);
+			}
+		}
+		return ret;
+	}
+}
+
+#endif  // LH_MEMORY_USAGE_H
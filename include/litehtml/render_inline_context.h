@@ -28,17 +28,19 @@ namespace litehtml
 			explicit inlines_item(const std::shared_ptr<render_item>& el) : element(el) {}
 		};
 	protected:
-		std::vector<std::unique_ptr<litehtml::line_box>> m_line_boxes;
-		rendered_width									 m_rendered_width;
+		std::vector<litehtml::line_box>	m_line_boxes;
+		line_box_storage				m_line_box_storage;
+		line_box_item::vector			m_next_line_items;
+		rendered_width					m_rendered_width;
 
 		rendered_width _render_content(pixel_t x, pixel_t y, bool second_pass,
 									   const containing_block_context& self_size, formatting_context* fmt_ctx) override;
 		void fix_line_width(element_float flt,
 							const containing_block_context &self_size, formatting_context* fmt_ctx) override;
 
-		std::list<std::unique_ptr<line_box_item> > finish_last_box(bool end_of_render, const containing_block_context &self_size);
-		void place_inline(std::unique_ptr<line_box_item> item, const containing_block_context &self_size, formatting_context* fmt_ctx);
-		pixel_t new_box(const std::unique_ptr<line_box_item>& el, const containing_block_context& self_size,
+		void finish_last_box(bool end_of_render, const containing_block_context &self_size);
+		void place_inline(line_box_item item, const containing_block_context &self_size, formatting_context* fmt_ctx);
+		pixel_t new_box(line_box_item& el, const containing_block_context& self_size,
 						formatting_context* fmt_ctx);
 		void apply_vertical_align() override;
 
@@ -55,6 +57,7 @@ namespace litehtml
 
 		pixel_t get_first_baseline() override;
 		pixel_t get_last_baseline() override;
+		void add_memory_usage(document_memory_usage& usage) const override;
 	};
 }
 
@@ -18,6 +18,40 @@ namespace litehtml
 
     class render_item : public std::enable_shared_from_this<render_item>
     {
+    public:
+        // Hit-testing index. It is built after the layout by update_hit_index() and lets
+        // get_element_by_point() skip the subtrees that can't contain the point.
+        struct hit_index
+        {
+            position                                    bounds;             // hit area of the element and all descendants in the parent's content coordinates
+            bool                                        unbounded = true;   // bounds are not known (not indexed yet or position:fixed inside)
+            std::vector<std::shared_ptr<render_item>>   children;           // children in order, filled if they go from top to bottom
+            std::vector<pixel_t>                        tops;               // bounds top of children[i], non-decreasing
+            std::vector<pixel_t>                        max_bottom;         // maximum bounds bottom of children[0..i]
+        };
+
+        // Paint order of the children. It is built by update_paint_order() and holds, for every pass of
+        // draw_children(), only the children that draw something in this pass.
+        struct paint_order
+        {
+            struct item
+            {
+                std::shared_ptr<render_item>    el;
+                bool                            draw;       // draw the element itself
+                bool                            stacking;   // draw the children as a separate stacking context
+                bool                            children;   // draw the children in the same pass
+            };
+            typedef std::vector<item> vector;
+
+            std::vector<int>                    z_indexes;  // sorted unique z-indexes of the positioned elements (m_positioned)
+            vector                              blocks;
+            vector                              floats;
+            vector                              inlines;
+            std::vector<std::pair<int, vector>> positioned; // sorted by z-index
+
+            const vector* get(draw_flag flag, int zindex) const;
+        };
+
     protected:
         std::shared_ptr<element>                    m_element;
         std::weak_ptr<render_item>                  m_parent;
@@ -27,8 +61,15 @@ namespace litehtml
         margins						                m_borders;
         position					                m_pos;
         bool                                        m_skip;
+        bool                                        m_layout_pending;
+        bool                                        m_has_static_pos;
+        int                                         m_render_calls;     // for document::stats()
+        pointF                                      m_static_pos;       // position in the flow of the positioned element
         std::vector<std::shared_ptr<render_item>>   m_positioned;
     	std::shared_ptr<scroll_view>				m_scroll_view;
+        hit_index                                   m_hit_index;
+        paint_order                                 m_paint_order;
+        background_gradients_cache                  m_gradients_cache;
 
 		containing_block_context calculate_containing_block_context(const containing_block_context& cb_context);
 		void calc_cb_length(const css_length& len, pixel_t percent_base, containing_block_context::typed_pixel& out_value) const;
@@ -42,6 +83,9 @@ namespace litehtml
 
         virtual ~render_item() = default;
 
+        // Gradients of the background computed on the previous draw
+        background_gradients_cache& gradients_cache() { return m_gradients_cache; }
+
     	pixel_t get_scroll_left() const
 		{
 			return m_scroll_view ? m_scroll_view->get_left() : 0;
@@ -86,6 +130,12 @@ namespace litehtml
             return m_children;
         }
 
+        // Number of render() calls, more than one means the item was laid out again
+        int render_calls() const
+        {
+            return m_render_calls;
+        }
+
     	// Access to the m_pos
         position& pos()
         {
@@ -113,6 +163,17 @@ namespace litehtml
             m_skip = val;
         }
 
+        // true if the element was not laid out yet (see render_lazy)
+        bool layout_pending() const
+        {
+            return m_layout_pending;
+        }
+
+        void layout_pending(bool val)
+        {
+            m_layout_pending = val;
+        }
+
         pixel_t right() const
         {
             return left() + width();
@@ -419,7 +480,7 @@ namespace litehtml
 
         bool is_visible() const
         {
-            return !(m_skip || src_el()->css().get_display() == display_none || src_el()->css().get_visibility() != visibility_visible);
+            return !(m_skip || m_layout_pending || src_el()->css().get_display() == display_none || src_el()->css().get_visibility() != visibility_visible);
         }
 
 		bool is_flex_item() const
@@ -479,7 +540,15 @@ namespace litehtml
         std::shared_ptr<element> get_element_by_point(pixel_t x, pixel_t y, pixel_t client_x, pixel_t client_y,
         	const std::function<bool(const std::shared_ptr<render_item>&)>& check);
         bool is_point_inside( pixel_t x, pixel_t y ) const;
+        void update_hit_index();
+        void update_paint_order();
+        bool may_contain_point(pixel_t x, pixel_t y) const
+        {
+            return m_hit_index.unbounded || m_hit_index.bounds.is_point_inside(x, y);
+        }
         void dump(litehtml::dumper& cout);
+        // Adds the memory used by the render item and its children, see document::memory_usage()
+        virtual void add_memory_usage(document_memory_usage& usage) const;
 		position get_placement() const;
         virtual void y_shift(pixel_t shift);
         /**
@@ -1,6 +1,7 @@
 #ifndef LITEHTML_RENDER_TABLE_H
 #define LITEHTML_RENDER_TABLE_H
 
+#include <functional>
 #include "render_item.h"
 
 namespace litehtml
@@ -15,6 +16,12 @@ namespace litehtml
 
 		rendered_width _render(pixel_t x, pixel_t y, const containing_block_context& containing_block_size,
 							   formatting_context* fmt_ctx, bool second_pass) override;
+		rendered_width render_cells(pixel_t x, pixel_t y, const containing_block_context& containing_block_size,
+									const containing_block_context& self_size, formatting_context* fmt_ctx,
+									pixel_t table_width, pixel_t max_table_width);
+		// Calls func for every cell with an element. The cells are independent formatting contexts, so
+		// they are processed in parallel if the document has the layout thread pool.
+		void for_each_cell(const std::function<void(int col, int row, table_cell* cell)>& func);
 
 	public:
 		explicit render_item_table(std::shared_ptr<element>  src_el);
@@ -26,6 +33,7 @@ namespace litehtml
 		void draw_children(uint_ptr hdc, pixel_t x, pixel_t y, const position* clip, draw_flag flag, int zindex) override;
 		pixel_t get_draw_vertical_offset() override;
 		std::shared_ptr<render_item> init() override;
+		void add_memory_usage(document_memory_usage& usage) const override;
 	};
 
 	class render_item_table_part : public render_item
@@ -0,0 +1,50 @@
+#ifndef LH_RULE_TREE_H
+#define LH_RULE_TREE_H
+
+#include "style.h"
+
+namespace litehtml
+{
+	struct document_memory_usage;
+
+	/// Node of the rule tree of the document.
+	/// The path from the root to the node is the sequence of the styles applied to an element in the cascade
+	/// order: the styles of the matched rules and the presentational attributes. The elements with the same
+	/// sequence point to the same node, so they share the node and its cascaded style, which is built on the
+	/// first use. The importance of the declarations is resolved by style::combine() as for the element styles.
+	class rule_node
+	{
+		using children_map = std::map<const style*, std::unique_ptr<rule_node>>;
+
+		rule_node*								m_parent;
+		const style*							m_rule;			// nullptr for the root
+		std::unique_ptr<style>					m_own_rule;		// the rule owned by the node, see add_own()
+		children_map							m_children;
+		std::vector<std::unique_ptr<rule_node>>	m_own_children;	// the children with own rules, they are not shared
+		mutable std::unique_ptr<style>			m_cascaded;
+		mutable bool							m_has_vars = false;
+	public:
+		rule_node() : m_parent(nullptr), m_rule(nullptr) {}
+		rule_node(rule_node* parent, const style* rule) : m_parent(parent), m_rule(rule) {}
+
+		rule_node(const rule_node&) = delete;
+		rule_node& operator=(const rule_node&) = delete;
+
+		/// Returns the child node for the rule, creates it on the first call.
+		/// The rule must live as long as the tree, so it is a style of the document stylesheets.
+		rule_node* add(const style* rule);
+		/// Adds a child node owning the style, used for the declarations of one element
+		rule_node* add_own(style&& rule);
+
+		/// Returns the style cascaded from the rules on the path from the root
+		const style& cascaded() const;
+		/// Returns true if the cascaded style has var() values, they are substituted per element
+		bool has_vars() const;
+		/// Returns the cascaded value of the property without building the cascaded style
+		const property_value& get_property(string_id name) const;
+
+		void add_memory_usage(document_memory_usage& usage) const;
+	};
+}
+
+#endif  // LH_RULE_TREE_H
@@ -305,6 +305,7 @@ STRING_ID(
 	_flex_basis_,
 
 	_caption_side_,
+	_table_layout_,
 	_order_,
 
 	_counter_reset_,
@@ -359,6 +360,8 @@ extern const string_id star_id; // _id("*")
 
 string_id			   _id(const std::string& str);
 const std::string&	   _s(string_id id);
+// Returns the number of strings in the table and the estimated bytes used by it
+void				   string_ids_memory_usage(size_t& count, size_t& bytes);
 
 } // namespace litehtml
 
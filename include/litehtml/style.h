@@ -33,8 +33,8 @@ namespace litehtml
 		bool m_has_var   = false; // css_token_vector, parsing is delayed because of var()
 
 		property_value() {}
-		template<class T> property_value(const T& val, bool important, bool has_var = false)
-			: base(val), m_important(important), m_has_var(has_var) {}
+		template<class T> property_value(T&& val, bool important, bool has_var = false)
+			: base(std::forward<T>(val)), m_important(important), m_has_var(has_var) {}
 	};
 
 	class html_tag;
@@ -48,9 +48,9 @@ namespace litehtml
 		typedef std::vector<style::ptr>		vector;
 	private:
 		props_map							m_properties;
-		static std::map<string_id, string>	m_valid_values;
+		static const std::map<string_id, string>	m_valid_values;
 	public:
-		void add(const css_token_vector& tokens, const string& baseurl = "", document_container* container = nullptr);
+		void add(css_token_vector tokens,        const string& baseurl = "", document_container* container = nullptr);
 		void add(const string& txt,              const string& baseurl = "", document_container* container = nullptr);
 
 		void add_property(string_id name, const css_token_vector& tokens, const string& baseurl = "", bool important = false, document_container* container = nullptr);
@@ -63,9 +63,18 @@ namespace litehtml
 		{
 			m_properties.clear();
 		}
+		bool empty() const
+		{
+			return m_properties.empty();
+		}
+		// Returns true if any property has var() in the value
+		bool has_vars() const;
 
 		void subst_vars(const html_tag* el);
 
+		// Returns the bytes of the heap blocks owned by the style
+		size_t memory_usage() const;
+
 	private:
 		void inherit_property(string_id name, bool important);
 
@@ -99,7 +108,7 @@ namespace litehtml
 		void parse_flex(const css_token_vector& tokens, bool important);
 		void parse_align_self(string_id name, const css_token_vector& tokens, bool important);
 
-		void add_parsed_property(string_id name, const property_value& propval);
+		void add_parsed_property(string_id name, property_value propval);
 		void add_length_property(string_id name, css_token val, string keywords, int options, bool important);
 		template<class T> void add_four_properties(string_id top_name, T val[4], int n, bool important);
 		void remove_property(string_id name, bool important);
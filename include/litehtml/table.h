@@ -205,23 +205,31 @@ namespace litehtml
 		table_column::vector	m_columns;
 		table_row::vector		m_rows;
 		std::vector<std::shared_ptr<render_item>> m_captions;
+		std::vector<css_length>	m_columns_css_width;	// widths defined by table-column elements
 		pixel_t					m_top_captions_height;
 		pixel_t					m_bottom_captions_height;
+		bool					m_fixed_layout;
+		bool					m_has_colspan;		// true if any cell spans several columns
+		bool					m_has_rowspan;		// true if any cell spans several rows
 	public:
 
 		table_grid() :
 			m_rows_count(0),
 			m_cols_count(0),
 			m_top_captions_height(0),
-			m_bottom_captions_height(0)
+			m_bottom_captions_height(0),
+			m_fixed_layout(false),
+			m_has_colspan(false),
+			m_has_rowspan(false)
 		{
 		}
 
 		void			clear();
 		void			begin_row(const std::shared_ptr<render_item>& row);
 		void			add_cell(const std::shared_ptr<render_item>& el);
+		void			add_column(const css_length& css_width, int span);
 		bool			is_rowspanned(int r, int c);
-		void			finish();
+		void			finish(bool fixed_layout);
 		table_cell*		cell(int t_col, int t_row);
 		table_column&	column(int c)	{ return m_columns[c];	}
 		table_row&		row(int r)		{ return m_rows[r];		}
@@ -229,17 +237,22 @@ namespace litehtml
 
 		int				rows_count() const	{ return m_rows_count;	}
 		int				cols_count() const	{ return m_cols_count; }
+		bool			fixed_layout() const	{ return m_fixed_layout; }
 
 		void			top_captions_height(pixel_t height) { m_top_captions_height = height; }
 		pixel_t			top_captions_height() const { return m_top_captions_height; }
 		void			bottom_captions_height(pixel_t height) { m_bottom_captions_height = height; }
 		pixel_t			bottom_captions_height() const { return m_bottom_captions_height; }
+		// Returns the bytes of the heap blocks owned by the grid
+		size_t			memory_usage() const;
 
+		void			calc_columns_min_max();
 		void			distribute_max_width(pixel_t width, int start, int end);
 		void			distribute_min_width(pixel_t width, int start, int end);
 		void			distribute_width(pixel_t width, int start, int end);
 		void			distribute_width(pixel_t width, int start, int end, table_column_accessor* acc);
 		pixel_t			calc_table_width(pixel_t block_width, bool is_auto, pixel_t& min_table_width, pixel_t& max_table_width);
+		pixel_t			calc_fixed_table_width(pixel_t block_width);
 		void			calc_horizontal_positions(const margins& table_borders, border_collapse bc, pixel_t bdr_space_x);
 		void			calc_vertical_positions(const margins& table_borders, border_collapse bc, pixel_t bdr_space_y);
 		void			calc_rows_height(pixel_t blockHeight, pixel_t borderSpacingY);
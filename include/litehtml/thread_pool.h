@@ -0,0 +1,67 @@
+#ifndef LH_THREAD_POOL_H
+#define LH_THREAD_POOL_H
+
+#include <functional>
+#ifndef LITEHTML_NO_THREADS
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#endif
+
+namespace litehtml
+{
+	/// Fixed size pool of worker threads used to lay out independent subtrees in parallel.
+	/// parallel_for() may be called from any thread, including the pool workers: the calling
+	/// thread always takes part in its own job, so nested calls can't deadlock.
+	/// With LITEHTML_NO_THREADS defined the pool has no workers and parallel_for() runs serially.
+	class thread_pool
+	{
+#ifndef LITEHTML_NO_THREADS
+		struct job
+		{
+			const std::function<void(size_t)>*	func = nullptr;
+			size_t								count = 0;
+			std::atomic<size_t>					next {0};
+			std::atomic<size_t>					done {0};
+			std::exception_ptr					error;
+		};
+
+		std::vector<std::thread>			m_threads;
+		std::vector<std::shared_ptr<job>>	m_jobs;
+		std::mutex							m_mutex;
+		std::condition_variable				m_work_cv;
+		std::condition_variable				m_done_cv;
+		bool								m_stop = false;
+#endif
+	public:
+		/// Creates the pool with the given number of worker threads (calling thread is not counted).
+		explicit thread_pool(int threads);
+		~thread_pool();
+
+		thread_pool(const thread_pool&) = delete;
+		thread_pool& operator=(const thread_pool&) = delete;
+
+#ifndef LITEHTML_NO_THREADS
+		int threads_count() const { return (int) m_threads.size(); }
+#else
+		int threads_count() const { return 0; }
+#endif
+
+		/// Calls func(i) for every i in [0, count) and returns when all calls are finished.
+		/// The order of the calls is not defined. The first exception thrown by func is rethrown.
+		void parallel_for(size_t count, const std::function<void(size_t)>& func);
+
+#ifndef LITEHTML_NO_THREADS
+	private:
+		void worker();
+		bool run_one(job& j);
+		std::shared_ptr<job> find_job() const;
+#endif
+	};
+}
+
+#endif  // LH_THREAD_POOL_H
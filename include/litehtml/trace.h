@@ -0,0 +1,59 @@
+#ifndef LH_TRACE_H
+#define LH_TRACE_H
+
+#include "types.h"
+#include <mutex>
+#include <iosfwd>
+
+namespace litehtml
+{
+	class element;
+
+	/// Receives the trace events of litehtml built with the LITEHTML_TRACE option, see
+	/// document_container::get_trace_sink(). Every event is one JSON object in the Chrome trace event format
+	/// (duration events "B" and "E"). With the parallel layout the events come from several threads at once.
+	class trace_sink
+	{
+	public:
+		virtual ~trace_sink() = default;
+		virtual void add_event(const string& json) = 0;
+	};
+
+	/// Writes the events into the stream as a JSON array, which can be opened in Perfetto or chrome://tracing.
+	class trace_stream_sink : public trace_sink
+	{
+		std::ostream&	m_out;
+		std::mutex		m_mutex;
+		bool			m_first = true;
+	public:
+		explicit trace_stream_sink(std::ostream& out) : m_out(out) {}
+		~trace_stream_sink() override;
+
+		void add_event(const string& json) override;
+	};
+
+	/// Sends the begin event on construction and the end event on destruction. Does nothing if the sink is nullptr.
+	class trace_scope
+	{
+		trace_sink*	m_sink;
+		const char*	m_name;
+	public:
+		trace_scope(trace_sink* sink, const char* name, element* el = nullptr);
+		~trace_scope();
+
+		trace_scope(const trace_scope&) = delete;
+		trace_scope& operator=(const trace_scope&) = delete;
+	};
+}
+
+// LH_TRACE_SCOPE(sink_expr, name, element_ptr) traces the rest of the scope. The arguments are not evaluated
+// if litehtml is built without LITEHTML_TRACE.
+#ifdef LITEHTML_TRACE
+#define LH_TRACE_CONCAT_(a, b) a##b
+#define LH_TRACE_CONCAT(a, b) LH_TRACE_CONCAT_(a, b)
+#define LH_TRACE_SCOPE(sink, name, el) litehtml::trace_scope LH_TRACE_CONCAT(lh_trace_scope_, __LINE__)(sink, name, el)
+#else
+#define LH_TRACE_SCOPE(sink, name, el)
+#endif
+
+#endif  // LH_TRACE_H
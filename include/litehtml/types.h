@@ -46,6 +46,21 @@ namespace litehtml
 		template<class T> T& get() { return std::get<T>(*this); }
 	};
 
+	// The golden ratio constant of the size_t width, the 64-bit one would be truncated on 32-bit platforms
+	constexpr size_t hash_golden_ratio = (size_t) (sizeof(size_t) >= 8 ? 0x9e3779b97f4a7c15ull : 0x9e3779b9ull);
+
+	inline size_t hash_combine(size_t seed, size_t val)
+	{
+		return seed ^ (val + hash_golden_ratio + (seed << 6) + (seed >> 2));
+	}
+
+	// Hash function of the unordered containers for the types with the hash() method
+	template<class T>
+	struct hash_method
+	{
+		size_t operator()(const T& val) const { return val.hash(); }
+	};
+
 	enum document_mode
 	{
 		no_quirks_mode,
@@ -316,14 +331,6 @@ namespace litehtml
 		pixel_t base_line() const	{ return descent; }
 	};
 
-	struct font_item
-	{
-		uint_ptr		font;
-		font_metrics	metrics;
-	};
-
-	using fonts_map = std::map<string, font_item>;
-
 	enum draw_flag
 	{
 		draw_root,
@@ -757,6 +764,7 @@ namespace litehtml
 		std::shared_ptr<render_item>	el;
 		int								context;
 		pixel_t							min_width;
+		bool							shifted = false;	// the relative shift is applied to el
 
 		floated_box() = default;
 		floated_box(const floated_box& val)
@@ -767,6 +775,7 @@ namespace litehtml
 			el = val.el;
 			context = val.context;
 			min_width = val.min_width;
+			shifted = val.shifted;
 		}
 
 		floated_box& operator=(const floated_box& val) = default;
@@ -779,6 +788,7 @@ namespace litehtml
 			el = std::move(val.el);
 			context = val.context;
 			min_width = val.min_width;
+			shifted = val.shifted;
 		}
 		void operator=(floated_box&& val)
 		{
@@ -788,6 +798,7 @@ namespace litehtml
 			el = std::move(val.el);
 			context = val.context;
 			min_width = val.min_width;
+			shifted = val.shifted;
 		}
 	};
 
@@ -1005,6 +1016,7 @@ namespace litehtml
 		render_all,
 		render_no_fixed,
 		render_fixed_only,
+		render_lazy,		// lay out the viewport plus a margin, the rest is laid out on demand
 	};
 
 	const char* const split_delims_spaces = " \t\r\n\f\v";
@@ -1105,6 +1117,14 @@ namespace litehtml
 		caption_side_top,
 		caption_side_bottom
 	};
+
+#define table_layout_strings		"auto;fixed"
+
+	enum table_layout
+	{
+		table_layout_auto,
+		table_layout_fixed
+	};
 }
 
 #endif  // LH_TYPES_H
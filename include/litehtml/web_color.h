@@ -27,6 +27,7 @@ namespace litehtml
 
 		bool operator==(web_color color) const { return red == color.red && green == color.green && blue == color.blue && alpha == color.alpha; }
 		bool operator!=(web_color color) const { return !(*this == color); }
+		size_t hash() const { return (size_t) red << 24 | (size_t) green << 16 | (size_t) blue << 8 | alpha; }
 
 		web_color darken(double fraction) const;
 		string to_string() const;
@@ -1,4 +1,5 @@
 #include <cmath>
+#include <algorithm>
 
 #include "background.h"
 #include "render_item.h"
@@ -12,6 +13,45 @@
 namespace litehtml
 {
 
+const background background::empty;
+
+bool litehtml::background::operator==(const background& val) const
+{
+	return	m_color			== val.m_color &&
+			m_image			== val.m_image &&
+			m_baseurl		== val.m_baseurl &&
+			m_attachment	== val.m_attachment &&
+			m_position_x	== val.m_position_x &&
+			m_position_y	== val.m_position_y &&
+			m_size			== val.m_size &&
+			m_repeat		== val.m_repeat &&
+			m_clip			== val.m_clip &&
+			m_origin		== val.m_origin;
+}
+
+size_t litehtml::background::hash() const
+{
+	size_t ret = m_color.hash();
+	for(const auto& img : m_image)
+	{
+		ret = hash_combine(ret, (size_t) img.type);
+		if(img.type == image::type_url)
+		{
+			ret = hash_combine(ret, std::hash<string>()(img.url));
+		} else if(img.type == image::type_gradient)
+		{
+			ret = hash_combine(ret, (size_t) img.m_gradient.m_type);
+			ret = hash_combine(ret, img.m_gradient.m_colors.size());
+		}
+	}
+	// the sizes, attachments, clips and origins are left to operator==
+	ret = hash_combine(ret, m_position_x.size());
+	for(const auto& x : m_position_x)	ret = hash_combine(ret, x.hash());
+	for(const auto& y : m_position_y)	ret = hash_combine(ret, y.hash());
+	for(int repeat : m_repeat)			ret = hash_combine(ret, (size_t) repeat);
+	return ret;
+}
+
 bool litehtml::background::get_layer(int idx, position pos, const element* el, const std::shared_ptr<render_item>& ri, background_layer& layer) const
 {
 	if(idx < 0 || idx >= get_layers_number())
@@ -651,7 +691,41 @@ litehtml::background::layer_type litehtml::background::get_layer_type(int idx) c
 	return type_none;
 }
 
-void litehtml::background::draw_layer(uint_ptr hdc, int idx, const background_layer& layer, document_container* container) const
+// Returns the gradient from the cache, get_gradient is called if the cached one doesn't match.
+// Without the cache (items is null) the gradient is always built and kept in uncached.
+template<class T, class F>
+static const T* get_cached_gradient(litehtml::vector<litehtml::background_gradients_cache::item<T>>* items, std::unique_ptr<T>& uncached,
+									int idx, const litehtml::gradient& definition, const litehtml::background_layer& layer, F get_gradient)
+{
+	if(!items)
+	{
+		uncached = get_gradient();
+		return uncached.get();
+	}
+
+	auto iter = std::find_if(items->begin(), items->end(), [idx](const auto& item) { return item.idx == idx; });
+	if(iter == items->end())
+	{
+		iter = items->emplace(items->end());
+		iter->idx = idx;
+	} else if(iter->origin_box == layer.origin_box && iter->definition == definition)
+	{
+		return iter->is_empty ? nullptr : &iter->value;
+	}
+
+	auto gradient = get_gradient();
+	iter->definition	= definition;
+	iter->origin_box	= layer.origin_box;
+	iter->is_empty		= !gradient;
+	if(gradient)
+	{
+		iter->value = std::move(*gradient);
+		return &iter->value;
+	}
+	return nullptr;
+}
+
+void litehtml::background::draw_layer(uint_ptr hdc, int idx, const background_layer& layer, document_container* container, background_gradients_cache* cache) const
 {
 	switch (get_layer_type(idx))
 	{
@@ -677,7 +751,9 @@ void litehtml::background::draw_layer(uint_ptr hdc, int idx, const background_la
 		case background::type_linear_gradient:
 			if(layer.origin_box.width != 0 && layer.origin_box.height != 0)
 			{
-				auto gradient_layer = get_linear_gradient_layer(idx, layer);
+				std::unique_ptr<background_layer::linear_gradient> uncached;
+				auto gradient_layer = get_cached_gradient(cache ? &cache->linear : nullptr, uncached, idx, m_image[idx].m_gradient, layer,
+					[&] { return get_linear_gradient_layer(idx, layer); });
 				if(gradient_layer)
 				{
 					container->draw_linear_gradient(hdc, layer, *gradient_layer);
@@ -687,7 +763,9 @@ void litehtml::background::draw_layer(uint_ptr hdc, int idx, const background_la
 		case background::type_radial_gradient:
 			if(layer.origin_box.width != 0 && layer.origin_box.height != 0)
 			{
-				auto gradient_layer = get_radial_gradient_layer(idx, layer);
+				std::unique_ptr<background_layer::radial_gradient> uncached;
+				auto gradient_layer = get_cached_gradient(cache ? &cache->radial : nullptr, uncached, idx, m_image[idx].m_gradient, layer,
+					[&] { return get_radial_gradient_layer(idx, layer); });
 				if(gradient_layer)
 				{
 					container->draw_radial_gradient(hdc, layer, *gradient_layer);
@@ -697,7 +775,9 @@ void litehtml::background::draw_layer(uint_ptr hdc, int idx, const background_la
 		case background::type_conic_gradient:
 			if(layer.origin_box.width != 0 && layer.origin_box.height != 0)
 			{
-				auto gradient_layer = get_conic_gradient_layer(idx, layer);
+				std::unique_ptr<background_layer::conic_gradient> uncached;
+				auto gradient_layer = get_cached_gradient(cache ? &cache->conic : nullptr, uncached, idx, m_image[idx].m_gradient, layer,
+					[&] { return get_conic_gradient_layer(idx, layer); });
 				if(gradient_layer)
 				{
 					container->draw_conic_gradient(hdc, layer, *gradient_layer);
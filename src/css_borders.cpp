@@ -1,7 +1,23 @@
 #include "html.h"
 #include "borders.h"
 
+const litehtml::css_borders litehtml::css_borders::empty;
+
 litehtml::string litehtml::css_border::to_string() const
 {
 	return width.to_string() + "/" + index_value(style, border_style_strings) + "/" + color.to_string();
 }
+
+size_t litehtml::css_borders::hash() const
+{
+	size_t ret = 0;
+	for(const css_border* border : {&left, &top, &right, &bottom})
+	{
+		ret = hash_combine(ret, border->width.hash());
+		ret = hash_combine(ret, (size_t) border->style);
+		ret = hash_combine(ret, border->color.hash());
+	}
+	// the rounded borders usually have the same radius at all corners, operator== compares the rest
+	ret = hash_combine(ret, radius.top_left_x.hash());
+	return ret;
+}
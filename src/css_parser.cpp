@@ -113,15 +113,15 @@ void remove_whitespace(css_token_vector& tokens, keep_whitespace_fn keep_whitesp
 
 void componentize(css_token_vector& tokens)
 {
-	css_parser parser(tokens);
+	css_parser parser(std::move(tokens));
 	css_token_vector result;
 	while (true)
 	{
 		css_token tok = parser.consume_component_value();
 		if (tok.type == EOF) break;
-		result.push_back(tok);
+		result.push_back(std::move(tok));
 	}
-	tokens = result;
+	tokens = std::move(result);
 }
 
 // https://www.w3.org/TR/css-syntax-3/#normalize-into-a-token-stream
@@ -137,7 +137,7 @@ css_token_vector normalize(string input, int options, keep_whitespace_fn keep_wh
 {
 	filter_code_points(input);
 	auto tokens = tokenize(input);
-	return normalize(tokens, options, keep_whitespace);
+	return normalize(std::move(tokens), options, keep_whitespace);
 }
 
 // https://www.w3.org/TR/css-syntax-3/#parse-stylesheet
@@ -152,29 +152,37 @@ raw_rule::vector css_parser::parse_stylesheet(const string& input, bool top_leve
 	// 2. Normalize input, and set input to the result.
 	auto tokens = normalize(str);
 
-	return parse_stylesheet(tokens, top_level);
+	return parse_stylesheet(std::move(tokens), top_level);
 }
-raw_rule::vector css_parser::parse_stylesheet(const css_token_vector& input, bool top_level)
+raw_rule::vector css_parser::parse_stylesheet(css_token_vector input, bool top_level)
 {
 	// 3. Create a new stylesheet, with its location set to location.
 	// 4. Consume a list of rules from input, with the top-level flag set, and set the stylesheet’s value to the result.
 	// 5. Return the stylesheet.
-	return css_parser(input).consume_list_of_rules(top_level);
+	return css_parser(std::move(input)).consume_list_of_rules(top_level);
 }
 
 // https://www.w3.org/TR/css-syntax-3/#consume-the-next-input-token
-css_token css_parser::next_token()
+// The parser owns its tokens, the consumed component values are moved out of them (see consume_component_value),
+// so the returned token is not copied.
+css_token& css_parser::next_token()
 {
 	if (m_index == (int)m_tokens.size())
-		return css_token_type(EOF);
+	{
+		m_eof = css_token_type(EOF);
+		return m_eof;
+	}
 	else
 		return m_tokens[m_index++];
 }
 
-css_token css_parser::peek_token()
+const css_token& css_parser::peek_token()
 {
 	if (m_index == (int)m_tokens.size())
-		return css_token_type(EOF);
+	{
+		m_eof = css_token_type(EOF);
+		return m_eof;
+	}
 	else
 		return m_tokens[m_index];
 }
@@ -188,7 +196,7 @@ raw_rule::vector css_parser::consume_list_of_rules(bool top_level)
 	while (true)
 	{
 		// Repeatedly consume the next input token:
-		css_token token = next_token();
+		const css_token& token = next_token();
 
 		switch (token.type)
 		{
@@ -236,7 +244,7 @@ raw_rule::ptr css_parser::consume_qualified_rule()
 	while (true)
 	{
 		// Repeatedly consume the next input token:
-		css_token token = next_token();
+		css_token& token = next_token();
 
 		switch (token.type)
 		{
@@ -250,13 +258,12 @@ raw_rule::ptr css_parser::consume_qualified_rule()
 			return rule;
 		case CURLY_BLOCK:
 			// Assign the block to the qualified rule’s block. Return the qualified rule.
-			rule->block = token;
+			rule->block = std::move(token);
 			return rule;
 		default:
 			// Reconsume the current input token. Consume a component value. Append the returned value to the qualified rule’s prelude.
 			m_index--;
-			css_token value = consume_component_value();
-			rule->prelude.push_back(value);
+			rule->prelude.push_back(consume_component_value());
 		}
 	}
 }
@@ -266,13 +273,12 @@ raw_rule::ptr css_parser::consume_at_rule()
 {
 	// Consume the next input token. Create a new at-rule with its name set to the value of the current input token,
 	// its prelude initially set to an empty list, and its value initially set to nothing.
-	css_token token = next_token();
-	raw_rule::ptr rule = make_shared<raw_rule>(raw_rule::at, token.str);
+	raw_rule::ptr rule = make_shared<raw_rule>(raw_rule::at, next_token().str);
 
 	while (true)
 	{
 		// Repeatedly consume the next input token:
-		token = next_token();
+		css_token& token = next_token();
 
 		switch (token.type)
 		{
@@ -288,13 +294,12 @@ raw_rule::ptr css_parser::consume_at_rule()
 			return rule;
 		case CURLY_BLOCK:
 			// Assign the block to the at-rule’s block. Return the at-rule.
-			rule->block = token;
+			rule->block = std::move(token);
 			return rule;
 		default:
 			// Reconsume the current input token. Consume a component value. Append the returned value to the at-rule’s prelude.
 			m_index--;
-			css_token value = consume_component_value();
-			rule->prelude.push_back(value);
+			rule->prelude.push_back(consume_component_value());
 		}
 	}
 }
@@ -313,7 +318,7 @@ css_token css_parser::consume_simple_block(char opening_bracket)
 	while (true)
 	{
 		// Repeatedly consume the next input token and process it as follows:
-		css_token token = next_token();
+		const css_token& token = next_token();
 
 		if (token.type == closing_bracket)
 		{
@@ -328,8 +333,7 @@ css_token css_parser::consume_simple_block(char opening_bracket)
 		{
 			// Reconsume the current input token. Consume a component value and append it to the value of the block.
 			m_index--;
-			css_token val = consume_component_value();
-			block.value.push_back(val);
+			block.value.push_back(consume_component_value());
 		}
 	}
 }
@@ -338,7 +342,7 @@ css_token css_parser::consume_simple_block(char opening_bracket)
 css_token css_parser::consume_component_value()
 {
 	// Consume the next input token.
-	css_token token = next_token();
+	css_token& token = next_token();
 
 	switch (token.type)
 	{
@@ -350,9 +354,9 @@ css_token css_parser::consume_component_value()
 	case FUNCTION:
 		return consume_function(token.name);
 
-		// Otherwise, return the current input token.
+		// Otherwise, return the current input token. It is not reconsumed after this.
 	default:
-		return token;
+		return std::move(token);
 	}
 }
 
@@ -365,7 +369,7 @@ css_token css_parser::consume_function(const string& name)
 	while (true)
 	{
 		// Repeatedly consume the next input token and process it as follows:
-		css_token token = next_token();
+		const css_token& token = next_token();
 
 		switch (token.type)
 		{
@@ -379,8 +383,7 @@ css_token css_parser::consume_function(const string& name)
 		default:
 			// Reconsume the current input token. Consume a component value and append the returned value to the function’s value.
 			m_index--;
-			css_token val = consume_component_value();
-			function.value.push_back(val);
+			function.value.push_back(consume_component_value());
 		}
 	}
 }
@@ -401,8 +404,7 @@ raw_declaration css_parser::consume_declaration()
 {
 	// Consume the next input token. Create a new declaration with its name set to the value of
 	// the current input token and its value initially set to an empty list.
-	css_token token = next_token();
-	raw_declaration decl = {token.name};
+	raw_declaration decl = {next_token().name};
 	auto& value = decl.value;
 
 	// 1. While the next input token is a <whitespace-token>, consume the next input token.
@@ -450,7 +452,7 @@ void css_parser::consume_style_block_contents(/*out*/ raw_declaration::vector& d
 	while (true)
 	{
 		// Repeatedly consume the next input token:
-		css_token token = next_token();
+		css_token& token = next_token();
 
 		switch (token.type)
 		{
@@ -472,13 +474,14 @@ void css_parser::consume_style_block_contents(/*out*/ raw_declaration::vector& d
 		}
 		case IDENT: {
 			// Initialize a temporary list initially filled with the current input token.
-			css_token_vector temp = { token };
+			css_token_vector temp;
+			temp.push_back(std::move(token));
 			// As long as the next input token is anything other than a <semicolon-token> or <EOF-token>,
 			// consume a component value and append it to the temporary list.
 			while (!is_one_of(peek_token().type, ';', EOF))
 				temp.push_back(consume_component_value());
 
-			css_parser parser(temp);
+			css_parser parser(std::move(temp));
 			// Consume a declaration from the temporary list.
 			auto decl = parser.consume_declaration();
 			// If anything was returned, append it to decls.
@@ -516,13 +519,13 @@ vector<css_token_vector> parse_comma_separated_list(const css_token_vector& toke
 	{
 		if (tok.type == ',')  // Note: EOF token is not stored in arrays
 		{
-			result.push_back(list);
+			result.push_back(std::move(list));
 			list.clear();
 			continue;
 		}
 		list.push_back(tok);
 	}
-	result.push_back(list);
+	result.push_back(std::move(list));
 
 	return result;
 }
@@ -7,6 +7,9 @@
 #include "types.h"
 
 #define offset(member) ((uint_ptr)&this->member - (uint_ptr)this)
+// the offsets in the shared values of the parent, see html_tag::get_property()
+#define borders_offset(member)	&css_properties::get_borders, ((uint_ptr)&borders.member - (uint_ptr)&borders)
+#define bg_offset(member)		&css_properties::get_bg, ((uint_ptr)&bg.member - (uint_ptr)&bg)
 //#define offset(func)	[](const css_properties& css) { return css.func; }
 
 void litehtml::css_properties::compute(const html_tag* el, const document::ptr& doc)
@@ -26,6 +29,7 @@ void litehtml::css_properties::compute(const html_tag* el, const document::ptr&
 	m_text_transform = (text_transform)		el->get_property<int>( _text_transform_,	true,	text_transform_none,		 offset(m_text_transform));
 	m_white_space	 = (white_space)		el->get_property<int>( _white_space_,		true,	white_space_normal,		 offset(m_white_space));
 	m_caption_side	 = (caption_side)		el->get_property<int>( _caption_side_,	true,	caption_side_top,		 offset(m_caption_side));
+	m_table_layout	 = (table_layout)		el->get_property<int>( _table_layout_,	false,	table_layout_auto,		 offset(m_table_layout));
 
 	// https://www.w3.org/TR/CSS22/visuren.html#dis-pos-flo
 	if (m_display == display_none)
@@ -152,55 +156,7 @@ void litehtml::css_properties::compute(const html_tag* el, const document::ptr&
 	doc->cvt_units(m_css_padding.top,	 m_font_metrics, 0);
 	doc->cvt_units(m_css_padding.bottom, m_font_metrics, 0);
 
-	m_css_borders.left.color   = get_color_property(el, _border_left_color_,   false, m_color, offset(m_css_borders.left.color));
-	m_css_borders.right.color  = get_color_property(el, _border_right_color_,  false, m_color, offset(m_css_borders.right.color));
-	m_css_borders.top.color    = get_color_property(el, _border_top_color_,    false, m_color, offset(m_css_borders.top.color));
-	m_css_borders.bottom.color = get_color_property(el, _border_bottom_color_, false, m_color, offset(m_css_borders.bottom.color));
-
-	m_css_borders.left.style   = (border_style) el->get_property<int>(_border_left_style_,   false, border_style_none, offset(m_css_borders.left.style));
-	m_css_borders.right.style  = (border_style) el->get_property<int>(_border_right_style_,  false, border_style_none, offset(m_css_borders.right.style));
-	m_css_borders.top.style    = (border_style) el->get_property<int>(_border_top_style_,    false, border_style_none, offset(m_css_borders.top.style));
-	m_css_borders.bottom.style = (border_style) el->get_property<int>(_border_bottom_style_, false, border_style_none, offset(m_css_borders.bottom.style));
-
-	m_css_borders.left.width   = el->get_property<css_length>(_border_left_width_,   false, border_width_medium_value, offset(m_css_borders.left.width));
-	m_css_borders.right.width  = el->get_property<css_length>(_border_right_width_,  false, border_width_medium_value, offset(m_css_borders.right.width));
-	m_css_borders.top.width    = el->get_property<css_length>(_border_top_width_,    false, border_width_medium_value, offset(m_css_borders.top.width));
-	m_css_borders.bottom.width = el->get_property<css_length>(_border_bottom_width_, false, border_width_medium_value, offset(m_css_borders.bottom.width));
-
-	if (m_css_borders.left.style == border_style_none || m_css_borders.left.style == border_style_hidden)
-		m_css_borders.left.width = 0;
-	if (m_css_borders.right.style == border_style_none || m_css_borders.right.style == border_style_hidden)
-		m_css_borders.right.width = 0;
-	if (m_css_borders.top.style == border_style_none || m_css_borders.top.style == border_style_hidden)
-		m_css_borders.top.width = 0;
-	if (m_css_borders.bottom.style == border_style_none || m_css_borders.bottom.style == border_style_hidden)
-		m_css_borders.bottom.width = 0;
-
-	snap_border_width(m_css_borders.left.width,		doc);
-	snap_border_width(m_css_borders.right.width,	doc);
-	snap_border_width(m_css_borders.top.width,		doc);
-	snap_border_width(m_css_borders.bottom.width,	doc);
-
-	m_css_borders.radius.top_left_x = el->get_property<css_length>(_border_top_left_radius_x_, false, 0, offset(m_css_borders.radius.top_left_x));
-	m_css_borders.radius.top_left_y = el->get_property<css_length>(_border_top_left_radius_y_, false, 0, offset(m_css_borders.radius.top_left_y));
-
-	m_css_borders.radius.top_right_x = el->get_property<css_length>(_border_top_right_radius_x_, false, 0, offset(m_css_borders.radius.top_right_x));
-	m_css_borders.radius.top_right_y = el->get_property<css_length>(_border_top_right_radius_y_, false, 0, offset(m_css_borders.radius.top_right_y));
-
-	m_css_borders.radius.bottom_left_x = el->get_property<css_length>(_border_bottom_left_radius_x_, false, 0, offset(m_css_borders.radius.bottom_left_x));
-	m_css_borders.radius.bottom_left_y = el->get_property<css_length>(_border_bottom_left_radius_y_, false, 0, offset(m_css_borders.radius.bottom_left_y));
-
-	m_css_borders.radius.bottom_right_x = el->get_property<css_length>(_border_bottom_right_radius_x_, false, 0, offset(m_css_borders.radius.bottom_right_x));
-	m_css_borders.radius.bottom_right_y = el->get_property<css_length>(_border_bottom_right_radius_y_, false, 0, offset(m_css_borders.radius.bottom_right_y));
-
-	doc->cvt_units( m_css_borders.radius.top_left_x,			m_font_metrics, 0);
-	doc->cvt_units( m_css_borders.radius.top_left_y,			m_font_metrics, 0);
-	doc->cvt_units( m_css_borders.radius.top_right_x,			m_font_metrics, 0);
-	doc->cvt_units( m_css_borders.radius.top_right_y,			m_font_metrics, 0);
-	doc->cvt_units( m_css_borders.radius.bottom_left_x,		m_font_metrics, 0);
-	doc->cvt_units( m_css_borders.radius.bottom_left_y,		m_font_metrics, 0);
-	doc->cvt_units( m_css_borders.radius.bottom_right_x,		m_font_metrics, 0);
-	doc->cvt_units( m_css_borders.radius.bottom_right_y,		m_font_metrics, 0);
+	compute_borders(el, doc);
 
 	m_border_collapse = (border_collapse) el->get_property<int>(_border_collapse_, true, border_collapse_separate, offset(m_border_collapse));
 
@@ -257,9 +213,10 @@ void litehtml::css_properties::compute(const html_tag* el, const document::ptr&
 }
 
 // used for all color properties except `color` (color:currentcolor is converted to color:inherit during parsing)
-litehtml::web_color litehtml::css_properties::get_color_property(const html_tag* el, string_id name, bool inherited, web_color default_value, uint_ptr member_offset) const
+template<class... Offset>
+litehtml::web_color litehtml::css_properties::get_color_property(const html_tag* el, string_id name, bool inherited, web_color default_value, Offset... member_offset) const
 {
-	web_color color = el->get_property<web_color>(name, inherited, default_value, member_offset);
+	web_color color = el->get_property<web_color>(name, inherited, default_value, member_offset...);
 	if (color.is_current_color) color = m_color;
 	return color;
 }
@@ -449,32 +406,91 @@ void litehtml::css_properties::compute_font(const html_tag* el, const document::
 	m_font = doc->get_font(descr, &m_font_metrics);
 }
 
+void litehtml::css_properties::compute_borders(const html_tag* el, const document::ptr& doc)
+{
+	css_borders borders;
+
+	borders.left.color   = get_color_property(el, _border_left_color_,   false, m_color, borders_offset(left.color));
+	borders.right.color  = get_color_property(el, _border_right_color_,  false, m_color, borders_offset(right.color));
+	borders.top.color    = get_color_property(el, _border_top_color_,    false, m_color, borders_offset(top.color));
+	borders.bottom.color = get_color_property(el, _border_bottom_color_, false, m_color, borders_offset(bottom.color));
+
+	borders.left.style   = (border_style) el->get_property<int>(_border_left_style_,   false, border_style_none, borders_offset(left.style));
+	borders.right.style  = (border_style) el->get_property<int>(_border_right_style_,  false, border_style_none, borders_offset(right.style));
+	borders.top.style    = (border_style) el->get_property<int>(_border_top_style_,    false, border_style_none, borders_offset(top.style));
+	borders.bottom.style = (border_style) el->get_property<int>(_border_bottom_style_, false, border_style_none, borders_offset(bottom.style));
+
+	borders.left.width   = el->get_property<css_length>(_border_left_width_,   false, border_width_medium_value, borders_offset(left.width));
+	borders.right.width  = el->get_property<css_length>(_border_right_width_,  false, border_width_medium_value, borders_offset(right.width));
+	borders.top.width    = el->get_property<css_length>(_border_top_width_,    false, border_width_medium_value, borders_offset(top.width));
+	borders.bottom.width = el->get_property<css_length>(_border_bottom_width_, false, border_width_medium_value, borders_offset(bottom.width));
+
+	if (borders.left.style == border_style_none || borders.left.style == border_style_hidden)
+		borders.left.width = 0;
+	if (borders.right.style == border_style_none || borders.right.style == border_style_hidden)
+		borders.right.width = 0;
+	if (borders.top.style == border_style_none || borders.top.style == border_style_hidden)
+		borders.top.width = 0;
+	if (borders.bottom.style == border_style_none || borders.bottom.style == border_style_hidden)
+		borders.bottom.width = 0;
+
+	snap_border_width(borders.left.width,		doc);
+	snap_border_width(borders.right.width,	doc);
+	snap_border_width(borders.top.width,		doc);
+	snap_border_width(borders.bottom.width,	doc);
+
+	borders.radius.top_left_x = el->get_property<css_length>(_border_top_left_radius_x_, false, 0, borders_offset(radius.top_left_x));
+	borders.radius.top_left_y = el->get_property<css_length>(_border_top_left_radius_y_, false, 0, borders_offset(radius.top_left_y));
+
+	borders.radius.top_right_x = el->get_property<css_length>(_border_top_right_radius_x_, false, 0, borders_offset(radius.top_right_x));
+	borders.radius.top_right_y = el->get_property<css_length>(_border_top_right_radius_y_, false, 0, borders_offset(radius.top_right_y));
+
+	borders.radius.bottom_left_x = el->get_property<css_length>(_border_bottom_left_radius_x_, false, 0, borders_offset(radius.bottom_left_x));
+	borders.radius.bottom_left_y = el->get_property<css_length>(_border_bottom_left_radius_y_, false, 0, borders_offset(radius.bottom_left_y));
+
+	borders.radius.bottom_right_x = el->get_property<css_length>(_border_bottom_right_radius_x_, false, 0, borders_offset(radius.bottom_right_x));
+	borders.radius.bottom_right_y = el->get_property<css_length>(_border_bottom_right_radius_y_, false, 0, borders_offset(radius.bottom_right_y));
+
+	doc->cvt_units( borders.radius.top_left_x,			m_font_metrics, 0);
+	doc->cvt_units( borders.radius.top_left_y,			m_font_metrics, 0);
+	doc->cvt_units( borders.radius.top_right_x,			m_font_metrics, 0);
+	doc->cvt_units( borders.radius.top_right_y,			m_font_metrics, 0);
+	doc->cvt_units( borders.radius.bottom_left_x,		m_font_metrics, 0);
+	doc->cvt_units( borders.radius.bottom_left_y,		m_font_metrics, 0);
+	doc->cvt_units( borders.radius.bottom_right_x,		m_font_metrics, 0);
+	doc->cvt_units( borders.radius.bottom_right_y,		m_font_metrics, 0);
+
+	m_css_borders = doc->add_borders(std::move(borders));
+}
+
 void litehtml::css_properties::compute_background(const html_tag* el, const document::ptr& doc)
 {
-	m_bg.m_color		= get_color_property(el, _background_color_, false, web_color::transparent, offset(m_bg.m_color));
+	background bg;
+
+	bg.m_color		= get_color_property(el, _background_color_, false, web_color::transparent, bg_offset(m_color));
 
 	const css_size auto_auto(css_length::predef_value(background_size_auto), css_length::predef_value(background_size_auto));
-	m_bg.m_position_x	= el->get_property<length_vector>(_background_position_x_, false, { css_length(0, css_units_percentage) }, offset(m_bg.m_position_x));
-	m_bg.m_position_y	= el->get_property<length_vector>(_background_position_y_, false, { css_length(0, css_units_percentage) }, offset(m_bg.m_position_y));
-	m_bg.m_size			= el->get_property<size_vector>  (_background_size_,       false, { auto_auto }, offset(m_bg.m_size));
+	bg.m_position_x	= el->get_property<length_vector>(_background_position_x_, false, { css_length(0, css_units_percentage) }, bg_offset(m_position_x));
+	bg.m_position_y	= el->get_property<length_vector>(_background_position_y_, false, { css_length(0, css_units_percentage) }, bg_offset(m_position_y));
+	bg.m_size			= el->get_property<size_vector>  (_background_size_,       false, { auto_auto }, bg_offset(m_size));
 
-	for (auto& x : m_bg.m_position_x) doc->cvt_units(x, m_font_metrics, 0);
-	for (auto& y : m_bg.m_position_y) doc->cvt_units(y, m_font_metrics, 0);
-	for (auto& size : m_bg.m_size)
+	for (auto& x : bg.m_position_x) doc->cvt_units(x, m_font_metrics, 0);
+	for (auto& y : bg.m_position_y) doc->cvt_units(y, m_font_metrics, 0);
+	for (auto& size : bg.m_size)
 	{
 		doc->cvt_units(size.width,  m_font_metrics, 0);
 		doc->cvt_units(size.height, m_font_metrics, 0);
 	}
 
-	m_bg.m_attachment = el->get_property<int_vector>(_background_attachment_, false, { background_attachment_scroll }, offset(m_bg.m_attachment));
-	m_bg.m_repeat     = el->get_property<int_vector>(_background_repeat_,     false, { background_repeat_repeat },     offset(m_bg.m_repeat));
-	m_bg.m_clip       = el->get_property<int_vector>(_background_clip_,       false, { background_box_border },        offset(m_bg.m_clip));
-	m_bg.m_origin     = el->get_property<int_vector>(_background_origin_,     false, { background_box_padding },       offset(m_bg.m_origin));
+	bg.m_attachment = el->get_property<int_vector>(_background_attachment_, false, { background_attachment_scroll }, bg_offset(m_attachment));
+	bg.m_repeat     = el->get_property<int_vector>(_background_repeat_,     false, { background_repeat_repeat },     bg_offset(m_repeat));
+	bg.m_clip       = el->get_property<int_vector>(_background_clip_,       false, { background_box_border },        bg_offset(m_clip));
+	bg.m_origin     = el->get_property<int_vector>(_background_origin_,     false, { background_box_padding },       bg_offset(m_origin));
 
-	m_bg.m_image   = el->get_property<vector<image>>(_background_image_,  false, {{}}, offset(m_bg.m_image));
-	m_bg.m_baseurl = el->get_property<string>(_background_image_baseurl_, false, "",   offset(m_bg.m_baseurl));
+	bg.m_image   = el->get_property<vector<image>>(_background_image_,  false, {{}}, bg_offset(m_image));
+	bg.m_baseurl = el->get_property<string>(_background_image_baseurl_, false, "",   bg_offset(m_baseurl));
 
-	for (auto& image : m_bg.m_image)
+	for (auto& image : bg.m_image)
 	{
 		switch (image.type)
 		{
@@ -484,7 +500,7 @@ void litehtml::css_properties::compute_background(const html_tag* el, const docu
 			case image::type_url:
 				if (!image.url.empty())
 				{
-					doc->container()->load_image(image.url.c_str(), m_bg.m_baseurl.c_str(), true);
+					doc->container()->load_image(image.url.c_str(), bg.m_baseurl.c_str(), true);
 				}
 				break;
 			case image::type_gradient:
@@ -496,6 +512,8 @@ void litehtml::css_properties::compute_background(const html_tag* el, const docu
 				break;
 		}
 	}
+
+	m_bg = doc->add_background(std::move(bg));
 }
 
 void litehtml::css_properties::compute_flex(const html_tag* el, const document::ptr& doc)
@@ -575,7 +593,7 @@ std::vector<std::tuple<litehtml::string, litehtml::string>> litehtml::css_proper
 	ret.emplace_back("clear", index_value(m_clear, element_clear_strings));
 	ret.emplace_back("margins", m_css_margins.to_string());
 	ret.emplace_back("padding", m_css_padding.to_string());
-	ret.emplace_back("borders", m_css_borders.to_string());
+	ret.emplace_back("borders", m_css_borders->to_string());
 	ret.emplace_back("width", m_css_width.to_string());
 	ret.emplace_back("height", m_css_height.to_string());
 	ret.emplace_back("min_width", m_css_min_width.to_string());
@@ -592,3 +610,13 @@ std::vector<std::tuple<litehtml::string, litehtml::string>> litehtml::css_proper
 
 	return ret;
 }
+
+size_t litehtml::css_properties::memory_usage() const
+{
+	return	heap_size(m_list_style_image) +
+			heap_size(m_list_style_image_baseurl) +
+			heap_size(m_font_family) +
+			heap_size(m_text_emphasis_style) +
+			heap_size(m_cursor) +
+			heap_size(m_content);
+}
@@ -27,7 +27,26 @@ char mirror(char c)
 
 string css_token::get_repr(bool insert_spaces) const
 {
-	if (!is_component_value()) return repr;
+	if (!is_component_value())
+	{
+		if (!repr.empty()) return repr;
+
+		// see is_default_repr()
+		switch (type)
+		{
+		case IDENT:			return name;
+		case FUNCTION:		return name + '(';
+		case AT_KEYWORD:	return '@' + name;
+		case HASH:			return '#' + name;
+		case STRING:		return '"' + str + '"';
+		case URL:			return "url(" + str + ')';
+		case CDO:			return "<!--";
+		case CDC:			return "-->";
+		default:
+			if (ch > 0 && ch < 0x80) return string(1, (char)ch);
+			return repr;
+		}
+	}
 
 	using litehtml::get_repr;
 	if (type == CV_FUNCTION) return name + '(' + get_repr(value, 0, -1, insert_spaces) + ')';
@@ -557,6 +576,41 @@ css_token css_tokenizer::consume_ident_like_token()
 }
 
 // https://www.w3.org/TR/css-syntax-3/#consume-token
+// Returns true if css_token::get_repr() builds the same text from the token, so it does not have to be stored.
+// Then the tokenizer does not allocate the repr strings for the most of the tokens.
+static bool is_default_repr(const css_token& token, const string& str, int start, int end)
+{
+	size_t len = end - start;
+	auto source_is = [&](const char* prefix, const string& value, const char* suffix)
+	{
+		size_t prefix_len = strlen(prefix);
+		size_t suffix_len = strlen(suffix);
+		return	len == prefix_len + value.size() + suffix_len &&
+				str.compare(start, prefix_len, prefix) == 0 &&
+				str.compare(start + prefix_len, value.size(), value) == 0 &&
+				str.compare(start + prefix_len + value.size(), suffix_len, suffix) == 0;
+	};
+
+	switch (token.type)
+	{
+	case WHITESPACE:	return len == 1 && str[start] == ' ';
+	case IDENT:			return source_is("", token.name, "");
+	case FUNCTION:		return source_is("", token.name, "(");
+	case AT_KEYWORD:	return source_is("@", token.name, "");
+	case HASH:			return source_is("#", token.name, "");
+	case STRING:		return source_is("\"", token.str, "\"");
+	case URL:			return source_is("url(", token.str, ")");
+	case CDO:
+	case CDC:			return true;
+	case BAD_STRING:
+	case BAD_URL:
+	case NUMBER:
+	case PERCENTAGE:
+	case DIMENSION:		return false;
+	default:			return token.ch > 0 && token.ch < 0x80 && len == 1;
+	}
+}
+
 css_token css_tokenizer::consume_token()
 {
 	consume_comments();
@@ -705,7 +759,8 @@ css_token css_tokenizer::consume_token()
 			token.ch = ch; // NOTE: :;,()[]{} tokens are also handled here
 	}
 
-	token.repr = str.substr(start, index - start);
+	if (!is_default_repr(token, str, start, index))
+		token.repr = str.substr(start, index - start);
 	return token;
 }
 
@@ -716,7 +771,7 @@ css_token_vector css_tokenizer::tokenize()
 	{
 		css_token token = consume_token();
 		if (token.type == EOF) break;
-		tokens.push_back(token);
+		tokens.push_back(std::move(token));
 	}
 	return tokens;
 }
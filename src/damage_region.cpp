@@ -0,0 +1,126 @@
+#include "damage_region.h"
+
+namespace
+{
+	litehtml::position unite(const litehtml::position& a, const litehtml::position& b)
+	{
+		litehtml::pixel_t left		= std::min(a.left(), b.left());
+		litehtml::pixel_t top		= std::min(a.top(), b.top());
+		litehtml::pixel_t right		= std::max(a.right(), b.right());
+		litehtml::pixel_t bottom	= std::max(a.bottom(), b.bottom());
+		return {left, top, right - left, bottom - top};
+	}
+
+	bool contains(const litehtml::position& a, const litehtml::position& b)
+	{
+		return a.left() <= b.left() && a.right() >= b.right() && a.top() <= b.top() && a.bottom() >= b.bottom();
+	}
+
+	litehtml::pixel_t area(const litehtml::position& a)
+	{
+		return a.width * a.height;
+	}
+
+	// Area covered by both rectangles
+	litehtml::pixel_t covered_area(const litehtml::position& a, const litehtml::position& b)
+	{
+		litehtml::pixel_t w = std::min(a.right(), b.right()) - std::max(a.left(), b.left());
+		litehtml::pixel_t h = std::min(a.bottom(), b.bottom()) - std::max(a.top(), b.top());
+		litehtml::pixel_t overlap = (w > 0 && h > 0) ? w * h : 0;
+		return area(a) + area(b) - overlap;
+	}
+}
+
+void litehtml::damage_region::add(const position& box)
+{
+	if(box.width <= 0 || box.height <= 0)
+	{
+		return;
+	}
+	for(const auto& rect : m_rects)
+	{
+		if(contains(rect, box))
+		{
+			return;
+		}
+	}
+	m_rects.erase(std::remove_if(m_rects.begin(), m_rects.end(),
+								 [&box](const position& rect) { return contains(box, rect); }),
+				  m_rects.end());
+	m_rects.push_back(box);
+	merge_overlapped(m_rects.size() - 1);
+	reduce();
+}
+
+void litehtml::damage_region::add(const position::vector& boxes)
+{
+	for(const auto& box : boxes)
+	{
+		add(box);
+	}
+}
+
+litehtml::position litehtml::damage_region::bounds() const
+{
+	if(m_rects.empty())
+	{
+		return {};
+	}
+	position ret = m_rects.front();
+	for(const auto& rect : m_rects)
+	{
+		ret = unite(ret, rect);
+	}
+	return ret;
+}
+
+// Merges the rectangle with the others while the union doesn't add too much area
+void litehtml::damage_region::merge_overlapped(size_t idx)
+{
+	bool merged = true;
+	while(merged)
+	{
+		merged = false;
+		for(size_t i = 0; i < m_rects.size(); i++)
+		{
+			if(i == idx) continue;
+
+			position united = unite(m_rects[idx], m_rects[i]);
+			if(area(united) <= covered_area(m_rects[idx], m_rects[i]) * m_max_overdraw)
+			{
+				m_rects[idx] = united;
+				m_rects.erase(m_rects.begin() + (ptrdiff_t) i);
+				if(i < idx) idx--;
+				merged = true;
+				break;
+			}
+		}
+	}
+}
+
+// Merges the pairs of rectangles adding the smallest area until the count limit is met
+void litehtml::damage_region::reduce()
+{
+	while(m_rects.size() > (size_t) m_max_rects)
+	{
+		size_t best_i = 0;
+		size_t best_j = 1;
+		pixel_t best_waste = -1;
+		for(size_t i = 0; i < m_rects.size(); i++)
+		{
+			for(size_t j = i + 1; j < m_rects.size(); j++)
+			{
+				pixel_t waste = area(unite(m_rects[i], m_rects[j])) - covered_area(m_rects[i], m_rects[j]);
+				if(best_waste < 0 || waste < best_waste)
+				{
+					best_waste = waste;
+					best_i = i;
+					best_j = j;
+				}
+			}
+		}
+		m_rects[best_i] = unite(m_rects[best_i], m_rects[best_j]);
+		m_rects.erase(m_rects.begin() + (ptrdiff_t) best_j);
+		merge_overlapped(best_i);
+	}
+}
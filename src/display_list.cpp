@@ -0,0 +1,521 @@
+#include "display_list.h"
+#include "document.h"
+
+namespace
+{
+	// The root background fills the whole clipping rectangle, see html_tag::draw_background
+	bool need_place_layer(const litehtml::background_layer& layer, bool shift, const litehtml::position* clip)
+	{
+		return shift || (layer.is_root && clip);
+	}
+
+	litehtml::background_layer place_layer(const litehtml::background_layer& layer, litehtml::pixel_t dx, litehtml::pixel_t dy, const litehtml::position* clip)
+	{
+		litehtml::background_layer ret = layer;
+		ret.origin_box.x	+= dx;
+		ret.origin_box.y	+= dy;
+		if(layer.is_root && clip)
+		{
+			ret.border_box	= *clip;
+			ret.clip_box	= *clip;
+			ret.border_box.round();
+			ret.clip_box.round();
+		} else
+		{
+			ret.border_box.x	+= dx;
+			ret.border_box.y	+= dy;
+			ret.clip_box.x		+= dx;
+			ret.clip_box.y		+= dy;
+		}
+		return ret;
+	}
+
+	void shift_point(litehtml::pointF& pt, litehtml::pixel_t dx, litehtml::pixel_t dy)
+	{
+		pt.x += (float) dx;
+		pt.y += (float) dy;
+	}
+
+	void add_box(litehtml::position& box, bool& has_box, const litehtml::position& val)
+	{
+		if(!has_box)
+		{
+			box		= val;
+			has_box	= true;
+		} else
+		{
+			litehtml::pixel_t left		= std::min(box.left(), val.left());
+			litehtml::pixel_t top		= std::min(box.top(), val.top());
+			litehtml::pixel_t right		= std::max(box.right(), val.right());
+			litehtml::pixel_t bottom	= std::max(box.bottom(), val.bottom());
+			box = litehtml::position(left, top, right - left, bottom - top);
+		}
+	}
+}
+
+void litehtml::display_list::clear()
+{
+	m_ops.clear();
+	m_texts.clear();
+	m_list_markers.clear();
+	m_images.clear();
+	m_solid_fills.clear();
+	m_linear_gradients.clear();
+	m_radial_gradients.clear();
+	m_conic_gradients.clear();
+	m_borders.clear();
+	m_clips.clear();
+	m_open_groups.clear();
+}
+
+void litehtml::display_list::add_op(op_type type, int index, const position& box, bool fixed, bool no_cull)
+{
+	m_ops.push_back({type, index, box, fixed, no_cull});
+
+	// Clipping draws nothing and is balanced inside the group, it doesn't change the group box
+	if(!m_open_groups.empty() && type != op_set_clip && type != op_del_clip)
+	{
+		auto& group = m_open_groups.back();
+		if(no_cull || fixed != group.fixed)
+		{
+			group.no_cull = true;
+		} else
+		{
+			add_box(group.box, group.has_box, box);
+		}
+	}
+}
+
+void litehtml::display_list::add_text(const char* text, uint_ptr font, web_color color, const position& pos, bool fixed)
+{
+	add_op(op_text, (int) m_texts.size(), pos, fixed);
+	m_texts.push_back({text, font, color, pos});
+}
+
+void litehtml::display_list::add_list_marker(const litehtml::list_marker& marker, bool fixed)
+{
+	add_op(op_list_marker, (int) m_list_markers.size(), marker.pos, fixed);
+	list_marker_op data;
+	data.marker			= marker;
+	data.marker.baseurl	= nullptr;
+	data.has_baseurl	= marker.baseurl != nullptr;
+	if(data.has_baseurl)
+	{
+		data.baseurl = marker.baseurl;
+	}
+	m_list_markers.push_back(std::move(data));
+}
+
+void litehtml::display_list::add_image(const background_layer& layer, const string& url, const string& base_url, bool fixed)
+{
+	add_op(op_image, (int) m_images.size(), layer.border_box, fixed, layer.is_root);
+	m_images.push_back({layer, url, base_url});
+}
+
+void litehtml::display_list::add_solid_fill(const background_layer& layer, const web_color& color, bool fixed)
+{
+	add_op(op_solid_fill, (int) m_solid_fills.size(), layer.border_box, fixed, layer.is_root);
+	m_solid_fills.push_back({layer, color});
+}
+
+void litehtml::display_list::add_linear_gradient(const background_layer& layer, const background_layer::linear_gradient& gradient, bool fixed)
+{
+	add_op(op_linear_gradient, (int) m_linear_gradients.size(), layer.border_box, fixed, layer.is_root);
+	m_linear_gradients.push_back({layer, gradient});
+}
+
+void litehtml::display_list::add_radial_gradient(const background_layer& layer, const background_layer::radial_gradient& gradient, bool fixed)
+{
+	add_op(op_radial_gradient, (int) m_radial_gradients.size(), layer.border_box, fixed, layer.is_root);
+	m_radial_gradients.push_back({layer, gradient});
+}
+
+void litehtml::display_list::add_conic_gradient(const background_layer& layer, const background_layer::conic_gradient& gradient, bool fixed)
+{
+	add_op(op_conic_gradient, (int) m_conic_gradients.size(), layer.border_box, fixed, layer.is_root);
+	m_conic_gradients.push_back({layer, gradient});
+}
+
+void litehtml::display_list::add_borders(const litehtml::borders& bdr, const position& draw_pos, bool root, bool fixed)
+{
+	add_op(op_borders, (int) m_borders.size(), draw_pos, fixed, root);
+	m_borders.push_back({bdr, draw_pos, root});
+}
+
+void litehtml::display_list::add_set_clip(const position& pos, const border_radiuses& radius, bool fixed)
+{
+	// Clipping is never culled to keep set_clip/del_clip balanced
+	add_op(op_set_clip, (int) m_clips.size(), pos, fixed, true);
+	m_clips.push_back({pos, radius});
+}
+
+void litehtml::display_list::add_del_clip(bool fixed)
+{
+	add_op(op_del_clip, 0, position(), fixed, true);
+}
+
+void litehtml::display_list::begin_group(bool fixed)
+{
+	m_open_groups.push_back({(int) m_ops.size(), (int) m_clips.size(), position(), false, fixed, false});
+	m_ops.push_back({op_group, 0, position(), fixed, false});
+}
+
+void litehtml::display_list::end_group()
+{
+	open_group group = m_open_groups.back();
+	m_open_groups.pop_back();
+
+	if(!group.has_box && !group.no_cull)
+	{
+		// Nothing is drawn in the group, there can be clipping only
+		m_ops.resize(group.op_index);
+		m_clips.resize(group.clips_count);
+		return;
+	}
+
+	auto& o = m_ops[group.op_index];
+	o.index		= (int) m_ops.size();
+	o.box		= group.box;
+	o.no_cull	= group.no_cull;
+
+	if(!m_open_groups.empty())
+	{
+		auto& parent = m_open_groups.back();
+		if(group.no_cull || group.fixed != parent.fixed)
+		{
+			parent.no_cull = true;
+		} else
+		{
+			add_box(parent.box, parent.has_box, group.box);
+		}
+	}
+}
+
+size_t litehtml::display_list::replay(document_container* container, uint_ptr hdc, pixel_t x, pixel_t y, const position* clip) const
+{
+	size_t ret = 0;
+	for(size_t i = 0; i < m_ops.size(); i++)
+	{
+		const auto& o = m_ops[i];
+		pixel_t dx = o.fixed ? 0 : x;
+		pixel_t dy = o.fixed ? 0 : y;
+		bool shift = dx != 0 || dy != 0;
+
+		if(clip && !o.no_cull)
+		{
+			position box = o.box;
+			box.x += dx;
+			box.y += dy;
+			if(!box.does_intersect(clip))
+			{
+				if(o.type == op_group)
+				{
+					i = o.index - 1;
+				}
+				continue;
+			}
+		}
+
+		switch(o.type)
+		{
+		case op_text:
+			{
+				const auto& data = m_texts[o.index];
+				position pos = data.pos;
+				pos.x += dx;
+				pos.y += dy;
+				container->draw_text(hdc, data.text.c_str(), data.font, data.color, pos);
+			}
+			break;
+		case op_list_marker:
+			{
+				const auto& data = m_list_markers[o.index];
+				litehtml::list_marker marker = data.marker;
+				marker.baseurl = data.has_baseurl ? data.baseurl.c_str() : nullptr;
+				marker.pos.x += dx;
+				marker.pos.y += dy;
+				container->draw_list_marker(hdc, marker);
+			}
+			break;
+		case op_image:
+			{
+				const auto& data = m_images[o.index];
+				if(need_place_layer(data.layer, shift, clip))
+				{
+					container->draw_image(hdc, place_layer(data.layer, dx, dy, clip), data.url, data.base_url);
+				} else
+				{
+					container->draw_image(hdc, data.layer, data.url, data.base_url);
+				}
+			}
+			break;
+		case op_solid_fill:
+			{
+				const auto& data = m_solid_fills[o.index];
+				if(need_place_layer(data.layer, shift, clip))
+				{
+					container->draw_solid_fill(hdc, place_layer(data.layer, dx, dy, clip), data.color);
+				} else
+				{
+					container->draw_solid_fill(hdc, data.layer, data.color);
+				}
+			}
+			break;
+		case op_linear_gradient:
+			{
+				const auto& data = m_linear_gradients[o.index];
+				if(need_place_layer(data.layer, shift, clip))
+				{
+					auto gradient = data.gradient;
+					shift_point(gradient.start, dx, dy);
+					shift_point(gradient.end, dx, dy);
+					container->draw_linear_gradient(hdc, place_layer(data.layer, dx, dy, clip), gradient);
+				} else
+				{
+					container->draw_linear_gradient(hdc, data.layer, data.gradient);
+				}
+			}
+			break;
+		case op_radial_gradient:
+			{
+				const auto& data = m_radial_gradients[o.index];
+				if(need_place_layer(data.layer, shift, clip))
+				{
+					auto gradient = data.gradient;
+					shift_point(gradient.position, dx, dy);
+					container->draw_radial_gradient(hdc, place_layer(data.layer, dx, dy, clip), gradient);
+				} else
+				{
+					container->draw_radial_gradient(hdc, data.layer, data.gradient);
+				}
+			}
+			break;
+		case op_conic_gradient:
+			{
+				const auto& data = m_conic_gradients[o.index];
+				if(need_place_layer(data.layer, shift, clip))
+				{
+					auto gradient = data.gradient;
+					shift_point(gradient.position, dx, dy);
+					container->draw_conic_gradient(hdc, place_layer(data.layer, dx, dy, clip), gradient);
+				} else
+				{
+					container->draw_conic_gradient(hdc, data.layer, data.gradient);
+				}
+			}
+			break;
+		case op_borders:
+			{
+				const auto& data = m_borders[o.index];
+				position draw_pos = data.draw_pos;
+				draw_pos.x += dx;
+				draw_pos.y += dy;
+				container->draw_borders(hdc, data.bdr, draw_pos, data.root);
+			}
+			break;
+		case op_set_clip:
+			{
+				const auto& data = m_clips[o.index];
+				position pos = data.pos;
+				pos.x += dx;
+				pos.y += dy;
+				container->set_clip(pos, data.radius);
+			}
+			break;
+		case op_del_clip:
+			container->del_clip();
+			break;
+		case op_group:
+			continue;
+		}
+		ret++;
+	}
+	return ret;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+litehtml::uint_ptr litehtml::display_list_recorder::create_font(const font_description& descr, const document* doc, font_metrics* fm)
+{
+	return m_container->create_font(descr, doc, fm);
+}
+
+void litehtml::display_list_recorder::delete_font(uint_ptr hFont)
+{
+	m_container->delete_font(hFont);
+}
+
+litehtml::pixel_t litehtml::display_list_recorder::text_width(const char* text, uint_ptr hFont)
+{
+	return m_container->text_width(text, hFont);
+}
+
+void litehtml::display_list_recorder::draw_text(uint_ptr /*hdc*/, const char* text, uint_ptr hFont, web_color color, const position& pos)
+{
+	m_list->add_text(text, hFont, color, pos, m_fixed_depth > 0);
+}
+
+litehtml::pixel_t litehtml::display_list_recorder::pt_to_px(float pt) const
+{
+	return m_container->pt_to_px(pt);
+}
+
+litehtml::pixel_t litehtml::display_list_recorder::get_default_font_size() const
+{
+	return m_container->get_default_font_size();
+}
+
+const char* litehtml::display_list_recorder::get_default_font_name() const
+{
+	return m_container->get_default_font_name();
+}
+
+void litehtml::display_list_recorder::draw_list_marker(uint_ptr /*hdc*/, const litehtml::list_marker& marker)
+{
+	m_list->add_list_marker(marker, m_fixed_depth > 0);
+}
+
+void litehtml::display_list_recorder::load_image(const char* src, const char* baseurl, bool redraw_on_ready)
+{
+	m_container->load_image(src, baseurl, redraw_on_ready);
+}
+
+void litehtml::display_list_recorder::get_image_size(const char* src, const char* baseurl, litehtml::size& sz)
+{
+	m_container->get_image_size(src, baseurl, sz);
+}
+
+void litehtml::display_list_recorder::draw_image(uint_ptr /*hdc*/, const background_layer& layer, const std::string& url, const std::string& base_url)
+{
+	m_list->add_image(layer, url, base_url, m_fixed_depth > 0);
+}
+
+void litehtml::display_list_recorder::draw_solid_fill(uint_ptr /*hdc*/, const background_layer& layer, const web_color& color)
+{
+	m_list->add_solid_fill(layer, color, m_fixed_depth > 0);
+}
+
+void litehtml::display_list_recorder::draw_linear_gradient(uint_ptr /*hdc*/, const background_layer& layer, const background_layer::linear_gradient& gradient)
+{
+	m_list->add_linear_gradient(layer, gradient, m_fixed_depth > 0);
+}
+
+void litehtml::display_list_recorder::draw_radial_gradient(uint_ptr /*hdc*/, const background_layer& layer, const background_layer::radial_gradient& gradient)
+{
+	m_list->add_radial_gradient(layer, gradient, m_fixed_depth > 0);
+}
+
+void litehtml::display_list_recorder::draw_conic_gradient(uint_ptr /*hdc*/, const background_layer& layer, const background_layer::conic_gradient& gradient)
+{
+	m_list->add_conic_gradient(layer, gradient, m_fixed_depth > 0);
+}
+
+void litehtml::display_list_recorder::draw_borders(uint_ptr /*hdc*/, const litehtml::borders& borders, const position& draw_pos, bool root)
+{
+	m_list->add_borders(borders, draw_pos, root, m_fixed_depth > 0);
+}
+
+void litehtml::display_list_recorder::set_caption(const char* caption)
+{
+	m_container->set_caption(caption);
+}
+
+void litehtml::display_list_recorder::set_base_url(const char* base_url)
+{
+	m_container->set_base_url(base_url);
+}
+
+void litehtml::display_list_recorder::link(const std::shared_ptr<document>& doc, const element::ptr& el)
+{
+	m_container->link(doc, el);
+}
+
+void litehtml::display_list_recorder::on_anchor_click(const char* url, const element::ptr& el)
+{
+	m_container->on_anchor_click(url, el);
+}
+
+bool litehtml::display_list_recorder::on_element_click(const element::ptr& el)
+{
+	return m_container->on_element_click(el);
+}
+
+void litehtml::display_list_recorder::on_mouse_event(const element::ptr& el, mouse_event event)
+{
+	m_container->on_mouse_event(el, event);
+}
+
+void litehtml::display_list_recorder::set_cursor(const char* cursor)
+{
+	m_container->set_cursor(cursor);
+}
+
+void litehtml::display_list_recorder::transform_text(string& text, text_transform tt)
+{
+	m_container->transform_text(text, tt);
+}
+
+void litehtml::display_list_recorder::import_css(string& text, const string& url, string& baseurl)
+{
+	m_container->import_css(text, url, baseurl);
+}
+
+void litehtml::display_list_recorder::set_clip(const position& pos, const border_radiuses& bdr_radius)
+{
+	m_list->add_set_clip(pos, bdr_radius, m_fixed_depth > 0);
+}
+
+void litehtml::display_list_recorder::del_clip()
+{
+	m_list->add_del_clip(m_fixed_depth > 0);
+}
+
+void litehtml::display_list_recorder::get_viewport(position& viewport) const
+{
+	m_container->get_viewport(viewport);
+}
+
+litehtml::element::ptr litehtml::display_list_recorder::create_element(const char* tag_name, const string_map& attributes, const std::shared_ptr<document>& doc)
+{
+	return m_container->create_element(tag_name, attributes, doc);
+}
+
+void litehtml::display_list_recorder::get_media_features(media_features& media) const
+{
+	m_container->get_media_features(media);
+}
+
+void litehtml::display_list_recorder::get_language(string& language, string& culture) const
+{
+	m_container->get_language(language, culture);
+}
+
+litehtml::string litehtml::display_list_recorder::resolve_color(const string& color) const
+{
+	return m_container->resolve_color(color);
+}
+
+void litehtml::display_list_recorder::split_text(const char* text, const std::function<void(const char*)>& on_word, const std::function<void(const char*)>& on_space)
+{
+	m_container->split_text(text, on_word, on_space);
+}
+
+litehtml::font_registry* litehtml::display_list_recorder::get_font_registry()
+{
+	return m_container->get_font_registry();
+}
+
+const void* litehtml::display_list_recorder::get_font_backend() const
+{
+	return m_container->get_font_backend();
+}
+
+bool litehtml::display_list_recorder::collect_stats() const
+{
+	return m_container->collect_stats();
+}
+
+litehtml::trace_sink* litehtml::display_list_recorder::get_trace_sink()
+{
+	return m_container->get_trace_sink();
+}
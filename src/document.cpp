@@ -9,6 +9,7 @@
 #include "el_image.h"
 #include "el_table.h"
 #include "el_td.h"
+#include "el_col.h"
 #include "el_link.h"
 #include "el_title.h"
 #include "el_style.h"
@@ -25,26 +26,55 @@
 #include "render_item.h"
 #include "render_table.h"
 #include "render_block.h"
+#include "formatting_context.h"
 #include "document_container.h"
+#include "thread_pool.h"
 #include "types.h"
+#include <chrono>
+#include <set>
 
 namespace litehtml
 {
 
+// Adds the wall time of its scope to the document_stats field, does nothing if the field is nullptr
+class stats_timer
+{
+	double*									m_time;
+	std::chrono::steady_clock::time_point	m_start;
+public:
+	explicit stats_timer(double* time) : m_time(time)
+	{
+		if(m_time) m_start = std::chrono::steady_clock::now();
+	}
+	~stats_timer()
+	{
+		if(m_time) *m_time += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_start).count();
+	}
+};
+
 document::document(document_container* container)
 {
-	m_container	= container;
+	m_container		= container;
+	m_font_registry	= container ? container->get_font_registry() : nullptr;
+	m_collect_stats	= container && container->collect_stats();
+	m_trace_sink	= container ? container->get_trace_sink() : nullptr;
 }
 
 document::~document()
 {
 	m_over_element = m_active_element = nullptr;
-	if(m_container)
+	if(m_font_registry)
 	{
-		for(auto& font : m_fonts)
-		{
-			m_container->delete_font(font.second.font);
-		}
+		m_fonts.for_each([this](const font_key& key, const font_item&)
+			{
+				m_font_registry->release_font(m_container, key);
+			});
+	} else if(m_container)
+	{
+		m_fonts.for_each([this](const font_key&, const font_item& item)
+			{
+				m_container->delete_font(item.font);
+			});
 	}
 }
 
@@ -57,37 +87,47 @@ document::ptr document::createFromString(
 	// Create litehtml::document
 	document::ptr doc = make_shared<document>(container);
 
-	// Parse document into GumboOutput
-	GumboOutput* output = doc->parse_html(str);
-
-	// mode must be set before doc->create_node because it is used in html_tag::set_attr
-	switch (output->document->v.document.doc_type_quirks_mode)
-	{
-	case GUMBO_DOCTYPE_NO_QUIRKS:      doc->m_mode = no_quirks_mode;      break;
-	case GUMBO_DOCTYPE_QUIRKS:         doc->m_mode = quirks_mode;         break;
-	case GUMBO_DOCTYPE_LIMITED_QUIRKS: doc->m_mode = limited_quirks_mode; break;
-	}
+	document_stats* stats = doc->m_collect_stats ? &doc->m_stats : nullptr;
 
-	// Create litehtml::elements.
+	GumboOutput* output;
 	elements_list root_elements;
-	doc->create_node(output->root, root_elements, true, true);
-	if (!root_elements.empty())
 	{
-		doc->m_root = root_elements.back();
-	}
+		stats_timer timer(stats ? &stats->parse_html_time : nullptr);
 
-	// Destroy GumboOutput
-	gumbo_destroy_output(&kGumboDefaultOptions, output);
+		// Parse document into GumboOutput
+		output = doc->parse_html(str);
 
-	if (master_styles != "")
-	{
-		doc->m_master_css.parse_css_stylesheet(master_styles, "", doc);
-		doc->m_master_css.sort_selectors();
+		// mode must be set before doc->create_node because it is used in html_tag::set_attr
+		switch (output->document->v.document.doc_type_quirks_mode)
+		{
+		case GUMBO_DOCTYPE_NO_QUIRKS:      doc->m_mode = no_quirks_mode;      break;
+		case GUMBO_DOCTYPE_QUIRKS:         doc->m_mode = quirks_mode;         break;
+		case GUMBO_DOCTYPE_LIMITED_QUIRKS: doc->m_mode = limited_quirks_mode; break;
+		}
+
+		// Create litehtml::elements.
+		doc->create_node(output->root, root_elements, true, true);
+		if (!root_elements.empty())
+		{
+			doc->m_root = root_elements.back();
+		}
+
+		// Destroy GumboOutput
+		gumbo_destroy_output(&kGumboDefaultOptions, output);
 	}
-	if (user_styles != "")
+
 	{
-		doc->m_user_css.parse_css_stylesheet(user_styles, "", doc);
-		doc->m_user_css.sort_selectors();
+		stats_timer timer(stats ? &stats->parse_css_time : nullptr);
+		if (master_styles != "")
+		{
+			doc->m_master_css.parse_css_stylesheet(master_styles, "", doc);
+			doc->m_master_css.sort_selectors();
+		}
+		if (user_styles != "")
+		{
+			doc->m_user_css.parse_css_stylesheet(user_styles, "", doc);
+			doc->m_user_css.sort_selectors();
+		}
 	}
 
 	// Let's process created elements tree
@@ -98,37 +138,52 @@ document::ptr document::createFromString(
 		doc->m_root->set_pseudo_class(_root_, true);
 
 		// apply master CSS
-		doc->m_root->apply_stylesheet(doc->m_master_css);
+		{
+			stats_timer timer(stats ? &stats->apply_stylesheets_time : nullptr);
+			doc->m_root->apply_stylesheet(doc->m_master_css);
+		}
 
 		// parse elements attributes
 		doc->m_root->parse_attributes();
 
 		// parse style sheets linked in document
-		for (const auto& css : doc->m_css)
 		{
-			media_query_list_list::ptr media;
-			if (css.media != "")
+			stats_timer timer(stats ? &stats->parse_css_time : nullptr);
+			for (const auto& css : doc->m_css)
 			{
-				auto mq_list = parse_media_query_list(css.media, doc);
-				media = make_shared<media_query_list_list>();
-				media->add(mq_list);
+				media_query_list_list::ptr media;
+				if (css.media != "")
+				{
+					auto mq_list = parse_media_query_list(css.media, doc);
+					media = make_shared<media_query_list_list>();
+					media->add(mq_list);
+				}
+				doc->m_styles.parse_css_stylesheet(css.text, css.baseurl, doc, media);
 			}
-			doc->m_styles.parse_css_stylesheet(css.text, css.baseurl, doc, media);
+			// Sort css selectors using CSS rules.
+			doc->m_styles.sort_selectors();
 		}
-		// Sort css selectors using CSS rules.
-		doc->m_styles.sort_selectors();
 
 		// Apply media features.
 		doc->update_media_lists(doc->m_media);
 
-		// Apply parsed styles.
-		doc->m_root->apply_stylesheet(doc->m_styles);
+		{
+			stats_timer timer(stats ? &stats->apply_stylesheets_time : nullptr);
 
-		// Apply user styles if any
-		doc->m_root->apply_stylesheet(doc->m_user_css);
+			// Apply parsed styles.
+			doc->m_root->apply_stylesheet(doc->m_styles);
+
+			// Apply user styles if any
+			doc->m_root->apply_stylesheet(doc->m_user_css);
+		}
 
 		// Initialize element::m_css
-		doc->m_root->compute_styles();
+		{
+			stats_timer timer(stats ? &stats->compute_styles_time : nullptr);
+			doc->m_root->compute_styles();
+		}
+
+		stats_timer timer(stats ? &stats->create_render_items_time : nullptr);
 
 		// Create rendering tree
 		doc->m_root_render = doc->m_root->create_render_item(nullptr);
@@ -394,6 +449,10 @@ element::ptr document::create_element(const char* tag_name, const string_map& at
 		{
 			newTag = std::make_shared<el_td>(this_doc);
 		}
+		else if (!strcmp(tag_name, "col") || !strcmp(tag_name, "colgroup"))
+		{
+			newTag = std::make_shared<el_col>(this_doc);
+		}
 		else if (!strcmp(tag_name, "link"))
 		{
 			newTag = std::make_shared<el_link>(this_doc);
@@ -452,25 +511,27 @@ element::ptr document::create_element(const char* tag_name, const string_map& at
 	return newTag;
 }
 
-uint_ptr document::add_font( const font_description& descr, font_metrics* fm )
+uint_ptr document::add_font( const font_key& key, const font_description& descr, font_metrics* fm )
 {
-	uint_ptr ret = 0;
-
-	std::string key = descr.hash();
+	font_item fi = {0, {}};
 
-	if(m_fonts.find(key) == m_fonts.end())
+	if(m_collect_stats)
+	{
+		m_stats.create_font_calls++;
+	}
+	if(m_font_registry)
+	{
+		fi.font = m_font_registry->get_font(m_container, key, descr, this, &fi.metrics);
+	} else
 	{
-		font_item fi = {0, {}};
-
 		fi.font = m_container->create_font(descr, this, &fi.metrics);
-		m_fonts[key] = fi;
-		ret = fi.font;
-		if(fm)
-		{
-			*fm = fi.metrics;
-		}
 	}
-	return ret;
+	m_fonts.insert(key, fi);
+	if(fm)
+	{
+		*fm = fi.metrics;
+	}
+	return fi.font;
 }
 
 uint_ptr document::get_font( const font_description& descr, font_metrics* fm )
@@ -480,23 +541,59 @@ uint_ptr document::get_font( const font_description& descr, font_metrics* fm )
 		return 0;
 	}
 
-	auto key = descr.hash();
-
-	auto el = m_fonts.find(key);
+	font_key key(descr);
 
-	if(el != m_fonts.end())
+	if(const font_item* fi = m_fonts.find(key))
 	{
 		if(fm)
 		{
-			*fm = el->second.metrics;
+			*fm = fi->metrics;
 		}
-		return el->second.font;
+		return fi->font;
 	}
-	return add_font(descr, fm);
+	return add_font(key, descr, fm);
 }
 
 pixel_t document::render( pixel_t max_width, render_type rt )
 {
+	pixel_t layout_limit = -1;
+	if(rt == render_lazy)
+	{
+		// Lay out the visible part and one more screen below it
+		position viewport;
+		m_container->get_viewport(viewport);
+		layout_limit = viewport.bottom() + viewport.height;
+	}
+	return render_layout(max_width, rt, layout_limit);
+}
+
+void document::ensure_layout(pixel_t bottom)
+{
+	if(!m_layout_pending || (bottom >= 0 && bottom <= m_layout_limit))
+	{
+		return;
+	}
+	litehtml::size old_size = m_size;
+	if(bottom < 0)
+	{
+		render_layout(m_render_width, render_all, -1, true);
+	} else
+	{
+		// Lay out one more screen below, like render() does
+		position viewport;
+		m_container->get_viewport(viewport);
+		render_layout(m_render_width, render_lazy, bottom + viewport.height, true);
+	}
+	if(m_size.width != old_size.width || m_size.height != old_size.height)
+	{
+		m_container->on_document_size_changed(m_size);
+	}
+}
+
+pixel_t document::render_layout(pixel_t max_width, render_type rt, pixel_t layout_limit, bool continue_layout)
+{
+	stats_timer timer(m_collect_stats ? &m_stats.layout_time : nullptr);
+
 	pixel_t ret = 0;
 	if(m_root && m_root_render)
 	{
@@ -512,9 +609,35 @@ pixel_t document::render( pixel_t max_width, render_type rt )
 		{
 			m_fixed_boxes.clear();
 			m_root_render->render_positioned(rt);
+			m_root_render->update_hit_index();
+			m_root_render->update_paint_order();
+			m_display_list_valid = false;
 		} else
 		{
-			ret = m_root_render->render(0, 0, cb_context, nullptr).natural_width;
+			// The stopped lazy layout continues from the blocks where it stopped. The laid out blocks are
+			// kept with their floats in the root context.
+			if(!continue_layout || !m_layout_ctx || max_width != m_render_width || !m_layout_ctx->continue_layout(layout_limit))
+			{
+				m_layout_ctx = std::make_unique<formatting_context>();
+				m_layout_ctx->set_layout_limit(layout_limit);
+			}
+			m_render_width	= max_width;
+			m_layout_limit	= layout_limit;
+
+			ret = m_root_render->render(0, 0, cb_context, m_layout_ctx.get()).natural_width;
+			if(m_layout_ctx->is_continuation_broken())
+			{
+				// A block couldn't continue, lay the document out from the top
+				m_layout_ctx = std::make_unique<formatting_context>();
+				m_layout_ctx->set_layout_limit(layout_limit);
+				ret = m_root_render->render(0, 0, cb_context, m_layout_ctx.get()).natural_width;
+			}
+			m_layout_pending = m_layout_ctx->is_layout_stopped();
+			if(!m_layout_pending)
+			{
+				m_layout_ctx = nullptr;
+			}
+			m_display_list_valid = false;
 			if(m_root_render->fetch_positioned())
 			{
 				m_fixed_boxes.clear();
@@ -523,18 +646,60 @@ pixel_t document::render( pixel_t max_width, render_type rt )
 			m_size.width	= 0;
 			m_size.height	= 0;
 			m_root_render->calc_document_size(m_size);
+			m_root_render->update_hit_index();
+			m_root_render->update_paint_order();
 		}
 	}
 	return ret;
 }
 
+void document::set_layout_threads(int threads)
+{
+#ifdef LITEHTML_NO_THREADS
+	// litehtml is built without threads: the layout is always serial
+	(void) threads;
+#else
+	if(threads <= 0)
+	{
+		m_layout_pool = nullptr;
+	} else if(!m_layout_pool || m_layout_pool->threads_count() != threads)
+	{
+		m_layout_pool = std::make_unique<thread_pool>(threads);
+	}
+#endif
+}
+
 void document::draw( uint_ptr hdc, pixel_t x, pixel_t y, const position* clip )
 {
 	if(m_root && m_root_render)
 	{
-		m_root->draw(hdc, x, y, clip, m_root_render);
-		m_root_render->draw_stacking_context(hdc, x, y, clip, true);
+		// The clip is in the window coordinates, the document is drawn at (x, y)
+		ensure_layout(clip ? clip->bottom() - y : -1);
+		stats_timer timer(m_collect_stats ? &m_stats.draw_time : nullptr);
+		size_t ops = get_display_list().replay(m_container, hdc, x, y, clip);
+		if(m_collect_stats)
+		{
+			m_stats.draw_ops += ops;
+		}
+	}
+}
+
+const display_list& document::get_display_list()
+{
+	if(!m_display_list_valid && m_root && m_root_render)
+	{
+		// Draw the whole document at the origin through the recorder
+		m_display_list.clear();
+		display_list_recorder recorder(m_container, &m_display_list);
+		m_recorder	= &recorder;
+		m_container	= &recorder;
+		m_root->draw(0, 0, 0, nullptr, m_root_render);
+		m_root_render->draw_stacking_context(0, 0, 0, nullptr, true);
+		m_container	= recorder.container();
+		m_recorder	= nullptr;
+		m_display_list_valid = true;
 	}
+	return m_display_list;
 }
 
 pixel_t document::to_pixels( const css_length& val, const font_metrics& metrics, pixel_t size ) const
@@ -628,7 +793,22 @@ void document::add_stylesheet( const char* str, const char* baseurl, const char*
 	}
 }
 
-bool document::on_mouse_over( pixel_t x, pixel_t y, pixel_t client_x, pixel_t client_y, position::vector& redraw_boxes )
+bool document::update_styles(damage_region& damage)
+{
+	m_display_list_valid = false;
+	position::vector redraw_boxes;
+	bool changed = m_root->find_styles_changes(redraw_boxes);
+	damage.add(redraw_boxes);
+	if(changed)
+	{
+		// The new styles can move the elements between the paint passes
+		m_root_render->update_paint_order();
+		return true;
+	}
+	return false;
+}
+
+bool document::on_mouse_over( pixel_t x, pixel_t y, pixel_t client_x, pixel_t client_y, damage_region& damage )
 {
 	if(!m_root || !m_root_render)
 	{
@@ -668,16 +848,24 @@ bool document::on_mouse_over( pixel_t x, pixel_t y, pixel_t client_x, pixel_t cl
 	if(state_was_changed)
 	{
 		m_container->on_mouse_event(m_over_element, mouse_event_enter);
-		return m_root->find_styles_changes(redraw_boxes);
+		return update_styles(damage);
 	}
 	return false;
 }
 
-std::vector<scroll_values> document::on_scroll(pixel_t dx, pixel_t dy, pixel_t x, pixel_t y, pixel_t client_x, pixel_t client_y) const
+std::vector<scroll_values> document::on_scroll(pixel_t dx, pixel_t dy, pixel_t x, pixel_t y, pixel_t client_x, pixel_t client_y)
 {
 	if(dy == 0 && dx == 0)
 		return {};
 
+	if(dy != 0.f && m_layout_pending)
+	{
+		// Lay out the part of the document the view is scrolled to if no element scrolls
+		position viewport;
+		m_container->get_viewport(viewport);
+		ensure_layout(viewport.bottom() + std::abs(dy));
+	}
+
 	element::ptr vscroll_el;
 	element::ptr hscroll_el;
 
@@ -698,6 +886,9 @@ std::vector<scroll_values> document::on_scroll(pixel_t dx, pixel_t dy, pixel_t x
 	if(!vscroll_el && !hscroll_el)
 		return {};
 
+	// The scroll shifts are baked into the display list
+	m_display_list_valid = false;
+
 	if(vscroll_el == hscroll_el)
 	{
 		scroll_values sv;
@@ -729,7 +920,7 @@ std::vector<scroll_values> document::on_scroll(pixel_t dx, pixel_t dy, pixel_t x
 	return ret;
 }
 
-bool document::on_mouse_leave( position::vector& redraw_boxes )
+bool document::on_mouse_leave( damage_region& damage )
 {
 	if(!m_root || !m_root_render)
 	{
@@ -742,13 +933,13 @@ bool document::on_mouse_leave( position::vector& redraw_boxes )
 		if(el->on_mouse_leave())
 		{
 			m_container->on_mouse_event(el, mouse_event_leave);
-			return m_root->find_styles_changes(redraw_boxes);
+			return update_styles(damage);
 		}
 	}
 	return false;
 }
 
-bool document::on_lbutton_down( pixel_t x, pixel_t y, pixel_t client_x, pixel_t client_y, position::vector& redraw_boxes )
+bool document::on_lbutton_down( pixel_t x, pixel_t y, pixel_t client_x, pixel_t client_y, damage_region& damage )
 {
 	if(!m_root || !m_root_render)
 	{
@@ -796,13 +987,13 @@ bool document::on_lbutton_down( pixel_t x, pixel_t y, pixel_t client_x, pixel_t
 	if(state_was_changed)
 	{
 		m_container->on_mouse_event(m_over_element, mouse_event_enter);
-		return m_root->find_styles_changes(redraw_boxes);
+		return update_styles(damage);
 	}
 
 	return false;
 }
 
-bool document::on_lbutton_up( pixel_t /*x*/, pixel_t /*y*/, pixel_t /*client_x*/, pixel_t /*client_y*/, position::vector& redraw_boxes )
+bool document::on_lbutton_up( pixel_t /*x*/, pixel_t /*y*/, pixel_t /*client_x*/, pixel_t /*client_y*/, damage_region& damage )
 {
 	if(!m_root || !m_root_render)
 	{
@@ -812,15 +1003,55 @@ bool document::on_lbutton_up( pixel_t /*x*/, pixel_t /*y*/, pixel_t /*client_x*/
 	{
 		if(m_over_element->on_lbutton_up(m_active_element == m_over_element))
 		{
-			return m_root->find_styles_changes(redraw_boxes);
+			return update_styles(damage);
 		}
 	}
 	return false;
 }
 
-bool document::on_button_cancel(position::vector& redraw_boxes) {
+bool document::on_button_cancel(damage_region& damage) {
 	m_active_element = nullptr;
-	return on_mouse_leave(redraw_boxes);
+	return on_mouse_leave(damage);
+}
+
+bool document::on_mouse_over( pixel_t x, pixel_t y, pixel_t client_x, pixel_t client_y, position::vector& redraw_boxes )
+{
+	damage_region damage;
+	bool ret = on_mouse_over(x, y, client_x, client_y, damage);
+	redraw_boxes.insert(redraw_boxes.end(), damage.rects().begin(), damage.rects().end());
+	return ret;
+}
+
+bool document::on_mouse_leave( position::vector& redraw_boxes )
+{
+	damage_region damage;
+	bool ret = on_mouse_leave(damage);
+	redraw_boxes.insert(redraw_boxes.end(), damage.rects().begin(), damage.rects().end());
+	return ret;
+}
+
+bool document::on_lbutton_down( pixel_t x, pixel_t y, pixel_t client_x, pixel_t client_y, position::vector& redraw_boxes )
+{
+	damage_region damage;
+	bool ret = on_lbutton_down(x, y, client_x, client_y, damage);
+	redraw_boxes.insert(redraw_boxes.end(), damage.rects().begin(), damage.rects().end());
+	return ret;
+}
+
+bool document::on_lbutton_up( pixel_t x, pixel_t y, pixel_t client_x, pixel_t client_y, position::vector& redraw_boxes )
+{
+	damage_region damage;
+	bool ret = on_lbutton_up(x, y, client_x, client_y, damage);
+	redraw_boxes.insert(redraw_boxes.end(), damage.rects().begin(), damage.rects().end());
+	return ret;
+}
+
+bool document::on_button_cancel(position::vector& redraw_boxes)
+{
+	damage_region damage;
+	bool ret = on_button_cancel(damage);
+	redraw_boxes.insert(redraw_boxes.end(), damage.rects().begin(), damage.rects().end());
+	return ret;
 }
 
 void document::get_fixed_boxes( position::vector& fixed_boxes )
@@ -981,7 +1212,8 @@ void document::fix_table_children(const std::shared_ptr<render_item>& el_ptr, st
 		{
 			if (!(*cur_iter)->src_el()->is_table_skip() || ((*cur_iter)->src_el()->is_table_skip() && !tmp.empty()))
 			{
-				if (disp != display_table_row_group || (*cur_iter)->src_el()->css().get_display() != display_table_caption)
+				if (disp != display_table_row_group || !is_one_of((*cur_iter)->src_el()->css().get_display(),
+					display_table_caption, display_table_column, display_table_column_group))
 				{
 					if (tmp.empty())
 					{
@@ -1166,4 +1398,103 @@ void document::dump(dumper& cout)
 	}
 }
 
+static void add_render_stats(const std::shared_ptr<render_item>& ri, document_stats& stats)
+{
+	stats.render_items++;
+	stats.render_calls += ri->render_calls();
+	stats.max_render_calls = std::max(stats.max_render_calls, (size_t) ri->render_calls());
+	for(const auto& child : ri->children())
+	{
+		add_render_stats(child, stats);
+	}
+}
+
+document_stats document::stats() const
+{
+	document_stats ret = m_stats;
+	ret.text_width_calls = m_text_width_calls.load(std::memory_order_relaxed);
+	if(m_collect_stats && m_root_render)
+	{
+		add_render_stats(m_root_render, ret);
+	}
+	return ret;
+}
+
+pixel_t document::text_width(const char* text, uint_ptr font)
+{
+	if(m_collect_stats)
+	{
+		m_text_width_calls.fetch_add(1, std::memory_order_relaxed);
+	}
+	return m_container->text_width(text, font);
+}
+
+// Adds the selectors of the stylesheet, the styles shared by several selectors are counted once
+static void add_stylesheet_memory_usage(const css& stylesheet, std::set<const style*>& styles, document_memory_usage& usage)
+{
+	usage.selectors += stylesheet.selectors().size();
+	usage.stylesheet_bytes += stylesheet.selectors().capacity() * sizeof(css_selector::ptr);
+	for(const auto& sel : stylesheet.selectors())
+	{
+		usage.stylesheet_bytes += sizeof(css_selector) + shared_count_size + heap_size(*sel);
+		if(sel->m_style && styles.insert(sel->m_style.get()).second)
+		{
+			usage.stylesheet_bytes += sizeof(style) + shared_count_size + sel->m_style->memory_usage();
+		}
+	}
+}
+
+document_memory_usage document::memory_usage() const
+{
+	document_memory_usage ret;
+	if(m_root)
+	{
+		m_root->add_memory_usage(ret);
+	}
+	if(m_root_render)
+	{
+		m_root_render->add_memory_usage(ret);
+	}
+
+	m_rule_tree.add_memory_usage(ret);
+
+	ret.shared_values = m_backgrounds.size() + m_borders.size();
+	ret.shared_value_bytes = heap_size(m_backgrounds) + heap_size(m_borders);
+
+	std::set<const style*> styles;
+	add_stylesheet_memory_usage(m_master_css, styles, ret);
+	add_stylesheet_memory_usage(m_user_css, styles, ret);
+	add_stylesheet_memory_usage(m_styles, styles, ret);
+	ret.stylesheet_bytes += m_css.capacity() * sizeof(css_text);
+	for(const auto& text : m_css)
+	{
+		ret.stylesheet_bytes += heap_size(text.text) + heap_size(text.baseurl) + heap_size(text.media);
+	}
+
+	ret.fonts = m_fonts.size();
+	ret.font_bytes = m_fonts.memory_usage();
+
+	string_ids_memory_usage(ret.string_ids, ret.string_id_bytes);
+	return ret;
+}
+
+const background* document::add_background(background&& bg)
+{
+	return &*m_backgrounds.insert(std::move(bg)).first;
+}
+
+const css_borders* document::add_borders(css_borders&& borders)
+{
+	return &*m_borders.insert(std::move(borders)).first;
+}
+
+void document::add_selector_matches(size_t attempts, size_t matches)
+{
+	if(m_collect_stats)
+	{
+		m_stats.selector_match_attempts += attempts;
+		m_stats.selector_matches += matches;
+	}
+}
+
 } // namespace litehtml
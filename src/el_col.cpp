@@ -0,0 +1,21 @@
+#include "el_col.h"
+#include "document.h"
+
+namespace litehtml
+{
+
+el_col::el_col(const shared_ptr<document>& doc) : html_tag(doc)
+{
+}
+
+void el_col::parse_attributes()
+{
+	// https://html.spec.whatwg.org/multipage/rendering.html#tables-2:attr-col-width
+	const char* str = get_attr("width");
+	if (str)
+		map_to_dimension_property_ignoring_zero(_width_, str);
+
+	html_tag::parse_attributes();
+}
+
+} // namespace litehtml
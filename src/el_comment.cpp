@@ -1,4 +1,5 @@
 #include "el_comment.h"
+#include "memory_usage.h"
 
 litehtml::el_comment::el_comment(const std::shared_ptr<document>& doc) : element(doc)
 {
@@ -22,3 +23,9 @@ void litehtml::el_comment::set_data( const char* data )
 		m_text += data;
 	}
 }
+
+void litehtml::el_comment::add_memory_usage(document_memory_usage& usage) const
+{
+	usage.element_bytes += heap_size(m_text);
+	add_element_memory_usage(usage, "#comment", sizeof(el_comment));
+}
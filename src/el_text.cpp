@@ -96,7 +96,7 @@ void litehtml::el_text::compute_styles(bool /*recursive*/)
 	} else
 	{
 		m_size.height	= fm.height;
-		m_size.width	= get_document()->container()->text_width(m_use_transformed ? m_transformed_text.c_str() : m_text.c_str(), font);
+		m_size.width	= get_document()->text_width(m_use_transformed ? m_transformed_text.c_str() : m_text.c_str(), font);
 	}
 	m_draw_spaces = fm.draw_spaces;
 }
@@ -140,3 +140,9 @@ std::vector<std::tuple<litehtml::string, litehtml::string>> litehtml::el_text::d
 {
 	return {};
 }
+
+void litehtml::el_text::add_memory_usage(document_memory_usage& usage) const
+{
+	usage.element_bytes += heap_size(m_text) + heap_size(m_transformed_text);
+	add_element_memory_usage(usage, is_space() ? "#space" : "#text", sizeof(el_text));
+}
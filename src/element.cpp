@@ -128,6 +128,26 @@ void element::dump(dumper& cout)
 	cout.end_node();
 }
 
+void element::add_memory_usage(document_memory_usage& usage) const
+{
+	add_element_memory_usage(usage, "#other", sizeof(element));
+}
+
+void element::add_element_memory_usage(document_memory_usage& usage, const string& type, size_t object_size) const
+{
+	usage.elements++;
+	usage.element_counts[type]++;
+	usage.element_bytes += object_size - sizeof(css_properties) + shared_count_size +
+						   heap_size(m_children) + heap_size(m_renders) + heap_size(m_counter_values);
+	usage.css_properties_bytes += sizeof(css_properties) + m_css.memory_usage();
+	usage.used_styles_bytes += heap_size(m_used_styles);
+
+	for(const auto& el : m_children)
+	{
+		el->add_memory_usage(usage);
+	}
+}
+
 std::shared_ptr<render_item> element::create_render_item(const std::shared_ptr<render_item>& parent_ri)
 {
 	std::shared_ptr<render_item> ret;
@@ -192,10 +212,10 @@ bool element::requires_styles_update()
 {
 	for (const auto& used_style : m_used_styles)
 	{
-		if(used_style->m_selector->is_media_valid())
+		if(used_style.m_selector->is_media_valid())
 		{
-			int res = select(*(used_style->m_selector), true);
-			if( (res == select_no_match && used_style->m_used) || (res == select_match && !used_style->m_used) )
+			int res = select(*used_style.m_selector, true);
+			if( (res == select_no_match && used_style.m_used) || (res == select_match && !used_style.m_used) )
 			{
 				return true;
 			}
@@ -1,5 +1,7 @@
 #include "flex_line.h"
 #include "flex_item.h"
+#include "document.h"
+#include "thread_pool.h"
 #include "types.h"
 
 void litehtml::flex_line::distribute_free_space(pixel_t container_main_size)
@@ -313,6 +315,35 @@ bool litehtml::flex_line::distribute_main_auto_margins(pixel_t free_main_size)
 	return false;
 }
 
+void litehtml::flex_line::render_items(const std::function<void(flex_item* item)>& func)
+{
+	thread_pool* pool = nullptr;
+	if(items.size() > 1)
+	{
+		pool = items.front()->el->src_el()->get_document()->layout_pool();
+	}
+	// Items can be rendered in parallel only if each of them has its own formatting context
+	if(pool && std::all_of(items.begin(), items.end(), [](const std::shared_ptr<flex_item>& item)
+		{
+			return item->el->src_el()->is_block_formatting_context();
+		}))
+	{
+		std::vector<flex_item*> items_list;
+		items_list.reserve(items.size());
+		for(auto& item : items)
+		{
+			items_list.push_back(item.get());
+		}
+		pool->parallel_for(items_list.size(), [&](size_t i) { func(items_list[i]); });
+	} else
+	{
+		for(auto& item : items)
+		{
+			func(item.get());
+		}
+	}
+}
+
 void litehtml::flex_line::init(pixel_t container_main_size, bool fit_container, bool is_row_direction,
 							   const litehtml::containing_block_context &self_size,
 							   litehtml::formatting_context *fmt_ctx)
@@ -355,12 +386,15 @@ void litehtml::flex_line::init(pixel_t container_main_size, bool fit_container,
 		/// Render items into new size
 		/// Find line cross_size
 		/// Find line first/last baseline
+		render_items([&](flex_item* item)
+			{
+				item->el->render(0,
+								 0,
+								 self_size.new_width(item->main_size - item->el->render_offset_width(), containing_block_context::size_mode_exact_width), fmt_ctx, false);
+			});
+
 		for (auto &item: items)
 		{
-			item->el->render(0,
-							 0,
-							 self_size.new_width(item->main_size - item->el->render_offset_width(), containing_block_context::size_mode_exact_width), fmt_ctx, false);
-
 			if((item->align & 0xFF) == flex_align_items_baseline)
 			{
 				if(item->align & flex_align_items_last)
@@ -422,15 +456,19 @@ void litehtml::flex_line::init(pixel_t container_main_size, bool fit_container,
 			}
 		}
 
+		render_items([&](flex_item* item)
+			{
+				pixel_t el_ret_width = item->el->render(0, 0, self_size, fmt_ctx, false).natural_width;
+				item->el->render(0, 0,
+								 self_size.new_width_height(el_ret_width - item->el->content_offset_width(),
+															item->main_size - item->el->content_offset_height(),
+															containing_block_context::size_mode_exact_width |
+																containing_block_context::size_mode_exact_height),
+								 fmt_ctx, false);
+			});
+
 		for (auto &item: items)
 		{
-			pixel_t el_ret_width = item->el->render(0, 0, self_size, fmt_ctx, false).natural_width;
-			item->el->render(0, 0,
-							 self_size.new_width_height(el_ret_width - item->el->content_offset_width(),
-														item->main_size - item->el->content_offset_height(),
-														containing_block_context::size_mode_exact_width |
-															containing_block_context::size_mode_exact_height),
-							 fmt_ctx, false);
 			main_size += item->el->height();
 			cross_size = std::max(cross_size, item->el->width());
 		}
@@ -0,0 +1,271 @@
+#include "font_registry.h"
+#include "document_container.h"
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+	uint32_t pack_color(const litehtml::web_color& color)
+	{
+		return (uint32_t) color.red << 24 | (uint32_t) color.green << 16 | (uint32_t) color.blue << 8 | color.alpha;
+	}
+
+	uint32_t float_bits(float val)
+	{
+		uint32_t bits;
+		memcpy(&bits, &val, sizeof(bits));
+		return bits;
+	}
+}
+
+litehtml::font_key::font_key(const font_description& descr)
+{
+	family				= _id(descr.family);
+	emphasis_style		= descr.emphasis_style.empty() ? empty_id : _id(descr.emphasis_style);
+	size				= descr.size;
+	weight				= descr.weight;
+	decoration_line		= descr.decoration_line;
+	emphasis_position	= descr.emphasis_position;
+	decoration_color	= pack_color(descr.decoration_color);
+	emphasis_color		= pack_color(descr.emphasis_color);
+	style				= (byte) descr.style;
+	decoration_style	= (byte) descr.decoration_style;
+	if(descr.decoration_thickness.is_predefined())
+	{
+		decoration_thickness = (float) descr.decoration_thickness.predef();
+		flags |= decoration_thickness_predefined;
+	} else
+	{
+		decoration_thickness = descr.decoration_thickness.val();
+		decoration_thickness_units = (byte) descr.decoration_thickness.units();
+	}
+	if(descr.decoration_color.is_current_color) flags |= decoration_current_color;
+	if(descr.emphasis_color.is_current_color) flags |= emphasis_current_color;
+}
+
+bool litehtml::font_key::operator==(const font_key& key) const
+{
+	return	family == key.family &&
+			emphasis_style == key.emphasis_style &&
+			size == key.size &&
+			decoration_thickness == key.decoration_thickness &&
+			weight == key.weight &&
+			decoration_line == key.decoration_line &&
+			emphasis_position == key.emphasis_position &&
+			decoration_color == key.decoration_color &&
+			emphasis_color == key.emphasis_color &&
+			style == key.style &&
+			decoration_style == key.decoration_style &&
+			decoration_thickness_units == key.decoration_thickness_units &&
+			flags == key.flags;
+}
+
+size_t litehtml::font_key::hash() const
+{
+	size_t ret = (size_t) family;
+	ret = hash_combine(ret, (size_t) emphasis_style);
+	ret = hash_combine(ret, float_bits(size));
+	ret = hash_combine(ret, float_bits(decoration_thickness));
+	ret = hash_combine(ret, (size_t) weight);
+	ret = hash_combine(ret, (size_t) decoration_line << 8 | (size_t) emphasis_position);
+	ret = hash_combine(ret, decoration_color);
+	ret = hash_combine(ret, emphasis_color);
+	ret = hash_combine(ret, (size_t) style << 24 | (size_t) decoration_style << 16 | (size_t) decoration_thickness_units << 8 | flags);
+	return ret;
+}
+
+const litehtml::font_item* litehtml::fonts_map::find(const font_key& key) const
+{
+	if(m_entries.empty())
+	{
+		return nullptr;
+	}
+	const entry& e = m_entries[find_slot(key, key.hash())];
+	return e.used ? &e.item : nullptr;
+}
+
+void litehtml::fonts_map::insert(const font_key& key, const font_item& item)
+{
+	// keep the load factor under 1/2, so the probe sequences are short
+	if((m_count + 1) * 2 > m_entries.size())
+	{
+		rehash(m_entries.empty() ? 16 : m_entries.size() * 2);
+	}
+	size_t hash = key.hash();
+	entry& e = m_entries[find_slot(key, hash)];
+	e = {key, item, hash, true};
+	m_count++;
+}
+
+void litehtml::fonts_map::clear()
+{
+	m_entries.clear();
+	m_count = 0;
+}
+
+// Linear probing: returns the slot with the key or the first free slot
+size_t litehtml::fonts_map::find_slot(const font_key& key, size_t hash) const
+{
+	size_t mask = m_entries.size() - 1;
+	size_t idx = hash & mask;
+	while(m_entries[idx].used && (m_entries[idx].hash != hash || m_entries[idx].key != key))
+	{
+		idx = (idx + 1) & mask;
+	}
+	return idx;
+}
+
+void litehtml::fonts_map::rehash(size_t capacity)
+{
+	std::vector<entry> entries(capacity);
+	std::swap(entries, m_entries);
+	for(const auto& e : entries)
+	{
+		if(e.used)
+		{
+			m_entries[find_slot(e.key, e.hash)] = e;
+		}
+	}
+}
+
+litehtml::font_registry& litehtml::font_registry::global()
+{
+	static font_registry registry;
+	return registry;
+}
+
+litehtml::uint_ptr litehtml::font_registry::get_font(document_container* container, const font_key& key,
+													 const font_description& descr, const document* doc, font_metrics* fm)
+{
+	entry_key ekey = {container->get_font_backend(), key};
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		if(std::find(m_containers.begin(), m_containers.end(), std::make_pair(container, ekey.backend)) == m_containers.end())
+		{
+			m_containers.emplace_back(container, ekey.backend);
+		}
+		auto it = m_fonts.find(ekey);
+		if(it != m_fonts.end())
+		{
+			return add_ref(it->second, fm);
+		}
+	}
+
+	// create_font() can be slow, so the other threads are not blocked while the font is created
+	font_item item = {0, {}};
+	item.font = container->create_font(descr, doc, &item.metrics);
+
+	uint_ptr ret;
+	bool created_twice;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		auto res = m_fonts.emplace(ekey, entry{item, container, 0, m_idle.end()});
+		created_twice = !res.second;
+		ret = add_ref(res.first->second, fm);
+	}
+	if(created_twice)
+	{
+		// Another thread has added the same font meanwhile
+		container->delete_font(item.font);
+	}
+	return ret;
+}
+
+void litehtml::font_registry::release_font(document_container* container, const font_key& key)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	auto it = m_fonts.find({container->get_font_backend(), key});
+	if(it == m_fonts.end() || it->second.refs == 0)
+	{
+		return;
+	}
+	if(--it->second.refs == 0)
+	{
+		it->second.idle_pos = m_idle.insert(m_idle.end(), it->first);
+		evict_idle();
+	}
+}
+
+void litehtml::font_registry::release(document_container* container)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	auto self = std::find_if(m_containers.begin(), m_containers.end(), [container](const auto& val) { return val.first == container; });
+	if(self == m_containers.end())
+	{
+		return;
+	}
+	const void* backend = self->second;
+	m_containers.erase(self);
+
+	auto heir = std::find_if(m_containers.begin(), m_containers.end(), [backend](const auto& val) { return val.second == backend; });
+	for(auto it = m_fonts.begin(); it != m_fonts.end();)
+	{
+		if(it->second.owner != container)
+		{
+			++it;
+		} else if(heir != m_containers.end())
+		{
+			it->second.owner = heir->first;
+			++it;
+		} else
+		{
+			if(it->second.idle_pos != m_idle.end())
+			{
+				m_idle.erase(it->second.idle_pos);
+			}
+			container->delete_font(it->second.item.font);
+			it = m_fonts.erase(it);
+		}
+	}
+}
+
+void litehtml::font_registry::set_max_idle_fonts(size_t max_idle_fonts)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_max_idle_fonts = max_idle_fonts;
+	evict_idle();
+}
+
+size_t litehtml::font_registry::size() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_fonts.size();
+}
+
+size_t litehtml::font_registry::idle_count() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_idle.size();
+}
+
+// Adds the reference to the font, the idle font becomes used. m_mutex must be locked.
+litehtml::uint_ptr litehtml::font_registry::add_ref(entry& e, font_metrics* fm)
+{
+	if(e.idle_pos != m_idle.end())
+	{
+		m_idle.erase(e.idle_pos);
+		e.idle_pos = m_idle.end();
+	}
+	e.refs++;
+	if(fm)
+	{
+		*fm = e.item.metrics;
+	}
+	return e.item.font;
+}
+
+// Deletes the least recently used idle fonts above the limit. m_mutex must be locked.
+void litehtml::font_registry::evict_idle()
+{
+	while(m_idle.size() > m_max_idle_fonts)
+	{
+		auto it = m_fonts.find(m_idle.front());
+		m_idle.pop_front();
+		it->second.owner->delete_font(it->second.item.font);
+		m_fonts.erase(it);
+	}
+}
@@ -544,10 +544,54 @@ void litehtml::formatting_context::update_floats(pixel_t dy, const std::shared_p
 
 void litehtml::formatting_context::apply_relative_shift(const containing_block_context &containing_block_size)
 {
-	for (const auto& fb : m_floats_left)
+	for (auto& fb : m_floats_left)
 	{
-		fb.el->apply_relative_shift(containing_block_size);
+		// The floats laid out before the lazy layout continued are shifted already
+		if(!fb.shifted)
+		{
+			fb.el->apply_relative_shift(containing_block_size);
+			fb.shifted = true;
+		}
+	}
+}
+
+bool litehtml::formatting_context::continue_layout(pixel_t limit)
+{
+	if(!m_layout_stopped || m_stopped_blocks.empty() || m_continuation_broken)
+	{
+		return false;
+	}
+	m_continued_blocks	= std::move(m_stopped_blocks);
+	m_stopped_blocks.clear();
+	m_layout_limit		= limit;
+	m_layout_stopped	= false;
+	return true;
+}
+
+const litehtml::formatting_context::stopped_block* litehtml::formatting_context::find_continued_block(const render_item* el) const
+{
+	for(const auto& block : m_continued_blocks)
+	{
+		if(block.el == el)
+		{
+			return &block;
+		}
+	}
+	return nullptr;
+}
+
+bool litehtml::formatting_context::take_continued_block(const render_item* el, stopped_block& block)
+{
+	for(auto iter = m_continued_blocks.begin(); iter != m_continued_blocks.end(); ++iter)
+	{
+		if(iter->el == el)
+		{
+			block = std::move(*iter);
+			m_continued_blocks.erase(iter);
+			return true;
+		}
 	}
+	return false;
 }
 
 litehtml::pixel_t litehtml::formatting_context::find_min_left(pixel_t y, int context_idx)
@@ -5,6 +5,23 @@
 namespace litehtml
 {
 
+bool gradient::operator==(const gradient& val) const
+{
+	return	m_type				== val.m_type &&
+			m_side				== val.m_side &&
+			angle				== val.angle &&
+			m_colors			== val.m_colors &&
+			position_x			== val.position_x &&
+			position_y			== val.position_y &&
+			radial_shape		== val.radial_shape &&
+			radial_extent		== val.radial_extent &&
+			radial_radius_x		== val.radial_radius_x &&
+			radial_radius_y		== val.radial_radius_y &&
+			conic_from_angle	== val.conic_from_angle &&
+			color_space			== val.color_space &&
+			hue_interpolation	== val.hue_interpolation;
+}
+
 bool parse_linear_gradient_direction(const css_token_vector& tokens, int& index, float& angle, int& side);
 bool parse_linear_gradient_direction_and_interpolation(const css_token_vector& tokens, gradient& gradient);
 bool parse_color_interpolation_method(const css_token_vector& tokens, int& index, color_space_t& color_space, hue_interpolation_t& hue_interpolation);
@@ -26,9 +26,7 @@ litehtml::html_tag::html_tag(const element::ptr& parent, const string& style) :
 	m_tag(empty_id),
 	m_id(empty_id)
 {
-	litehtml::style st;
-	st.add(style);
-	add_style(st);
+	m_style.add(style);
 	this->parent(parent);
 	compute_styles();
 }
@@ -181,6 +179,9 @@ litehtml::element::ptr litehtml::html_tag::select_one( const css_selector& selec
 
 void litehtml::html_tag::apply_stylesheet( const litehtml::css& stylesheet )
 {
+	LH_TRACE_SCOPE(get_document()->get_trace_sink(), "html_tag::apply_stylesheet", this);
+	size_t attempts = 0;
+	size_t matches = 0;
 	for(const auto& sel : stylesheet.selectors())
 	{
 		// optimization
@@ -198,10 +199,12 @@ void litehtml::html_tag::apply_stylesheet( const litehtml::css& stylesheet )
 		}
 
 		int apply = select(*sel, false);
+		attempts++;
 
 		if(apply != select_no_match)
 		{
-			used_selector::ptr us = std::make_unique<used_selector>(sel, false);
+			matches++;
+			used_selector us(sel.get(), false);
 
 			if(sel->is_media_valid())
 			{
@@ -238,7 +241,7 @@ void litehtml::html_tag::apply_stylesheet( const litehtml::css& stylesheet )
 								add_style(*sel->m_style);
 							}
 						}
-						us->m_used = true;
+						us.m_used = true;
 					};
 
 
@@ -252,7 +255,7 @@ void litehtml::html_tag::apply_stylesheet( const litehtml::css& stylesheet )
 						} else
 						{
 							add_style(*sel->m_style);
-							us->m_used = true;
+							us.m_used = true;
 						}
 					}
 				} else if((apply & (select_match_with_after | select_match_with_before)))
@@ -261,12 +264,16 @@ void litehtml::html_tag::apply_stylesheet( const litehtml::css& stylesheet )
 				} else
 				{
 					add_style(*sel->m_style);
-					us->m_used = true;
+					us.m_used = true;
 				}
 			}
-			m_used_styles.push_back(std::move(us));
+			m_used_styles.push_back(us);
 		}
 	}
+	if(auto doc = get_document())
+	{
+		doc->add_selector_matches(attempts, matches);
+	}
 
 	for(auto& el : m_children)
 	{
@@ -325,7 +332,7 @@ void litehtml::html_tag::draw(uint_ptr hdc, pixel_t x, pixel_t y, const position
 
 bool html_tag::get_custom_property(string_id name, css_token_vector& result) const
 {
-	const property_value& value = m_style.get_property(name);
+	const property_value& value = get_style().get_property(name);
 
 	if (value.is<css_token_vector>())
 	{
@@ -343,7 +350,16 @@ void litehtml::html_tag::compute_styles(bool recursive)
 {
 	const char* style = get_attr("style");
 	document::ptr doc = get_document();
+	LH_TRACE_SCOPE(doc->get_trace_sink(), "html_tag::compute_styles", this);
 
+	// The element shares the cascaded style of its rule node unless it has own declarations
+	if (m_rule_node && (style || !m_style.empty() || m_rule_node->has_vars()))
+	{
+		litehtml::style own = std::move(m_style);
+		m_style = m_rule_node->cascaded();
+		m_style.combine(own);
+		m_rule_node = nullptr;
+	}
 	if (style)
 	{
 		m_style.add(style, "", doc->container());
@@ -896,7 +912,7 @@ void litehtml::html_tag::draw_background(uint_ptr hdc, pixel_t x, pixel_t y, con
 					layer.clip_box.round();
 					layer.origin_box.round();
 
-					bg->draw_layer(hdc, i, layer, get_document()->container());
+					bg->draw_layer(hdc, i, layer, get_document()->container(), &ri->gradients_cache());
 				}
 			}
 
@@ -975,7 +991,7 @@ void litehtml::html_tag::draw_background(uint_ptr hdc, pixel_t x, pixel_t y, con
 						layer.clip_box.round();
 						layer.origin_box.round();
 
-						bg->draw_layer(hdc, i, layer, get_document()->container());
+						bg->draw_layer(hdc, i, layer, get_document()->container(), &ri->gradients_cache());
 					}
 				}
 				if(bdr.is_visible())
@@ -1122,7 +1138,7 @@ void litehtml::html_tag::draw_list_marker( uint_ptr hdc, const position& pos, co
 		{
 			if(lm.font)
 			{
-				auto tw_space = get_document()->container()->text_width(" ", lm.font);
+				auto tw_space = get_document()->text_width(" ", lm.font);
 				lm.pos.x = pos.x - tw_space * 2;
 				lm.pos.width = tw_space;
 			} else
@@ -1148,7 +1164,7 @@ void litehtml::html_tag::draw_list_marker( uint_ptr hdc, const position& pos, co
 			if(lm.font)
 			{
 				marker_text += ".";
-				auto tw = get_document()->container()->text_width(marker_text.c_str(), lm.font);
+				auto tw = get_document()->text_width(marker_text.c_str(), lm.font);
 				auto text_pos = lm.pos;
 				text_pos.move_to(text_pos.right() - tw, text_pos.y);
 				text_pos.width = tw;
@@ -1400,7 +1416,7 @@ litehtml::element::ptr litehtml::html_tag::get_element_after(const style& style,
 
 void litehtml::html_tag::handle_counter_properties()
 {
-	const auto& reset_property = m_style.get_property(_counter_reset_);
+	const auto& reset_property = get_cascaded_property(_counter_reset_);
 	if (reset_property.is<string_vector>()) {
 		auto reset_function = [&](const string_id&name_id, const int value) {
 			reset_counter(name_id, value);
@@ -1409,7 +1425,7 @@ void litehtml::html_tag::handle_counter_properties()
 		return;
 	}
 
-	const auto& inc_property = m_style.get_property(_counter_increment_);
+	const auto& inc_property = get_cascaded_property(_counter_increment_);
 	if (inc_property.is<string_vector>()) {
 		auto inc_function = [&](const string_id&name_id, const int value) {
 			increment_counter(name_id, value);
@@ -1420,12 +1436,36 @@ void litehtml::html_tag::handle_counter_properties()
 }
 
 
+// The style is added to the rule tree, so it must be a style of the document stylesheets
 void litehtml::html_tag::add_style(const style& style)
 {
-	m_style.combine(style);
+	rule_node* node = m_rule_node ? m_rule_node : get_document()->rule_tree();
+	if (!m_style.empty())
+	{
+		// the presentational attributes are applied between the master and the document stylesheets
+		node = node->add_own(std::move(m_style));
+		m_style.clear();
+	}
+	m_rule_node = node->add(&style);
 	handle_counter_properties();
 }
 
+const property_value& litehtml::html_tag::get_cascaded_property(string_id name) const
+{
+	const property_value& own_value = m_style.get_property(name);
+	if (!m_rule_node)
+	{
+		return own_value;
+	}
+	// m_style is applied after the rules
+	const property_value& rule_value = m_rule_node->get_property(name);
+	if (own_value.is<invalid>() || (rule_value.m_important && !own_value.m_important))
+	{
+		return rule_value;
+	}
+	return own_value;
+}
+
 void litehtml::html_tag::refresh_styles()
 {
 	for (auto& el : m_children)
@@ -1437,60 +1477,61 @@ void litehtml::html_tag::refresh_styles()
 	}
 
 	m_style.clear();
+	m_rule_node = nullptr;
 
 	for (auto& usel : m_used_styles)
 	{
-		usel->m_used = false;
+		usel.m_used = false;
 
-		if(usel->m_selector->is_media_valid())
+		if(usel.m_selector->is_media_valid())
 		{
-			int apply = select(*usel->m_selector, false);
+			int apply = select(*usel.m_selector, false);
 
 			if(apply != select_no_match)
 			{
 				if(apply & select_match_pseudo_class)
 				{
-					if(select(*usel->m_selector, true))
+					if(select(*usel.m_selector, true))
 					{
 						if(apply & select_match_with_after)
 						{
-							element::ptr el = get_element_after(*usel->m_selector->m_style, false);
+							element::ptr el = get_element_after(*usel.m_selector->m_style, false);
 							if(el)
 							{
-								el->add_style(*usel->m_selector->m_style);
+								el->add_style(*usel.m_selector->m_style);
 							}
 						} else if(apply & select_match_with_before)
 						{
-							element::ptr el = get_element_before(*usel->m_selector->m_style, false);
+							element::ptr el = get_element_before(*usel.m_selector->m_style, false);
 							if(el)
 							{
-								el->add_style(*usel->m_selector->m_style);
+								el->add_style(*usel.m_selector->m_style);
 							}
 						}
 						else
 						{
-							add_style(*usel->m_selector->m_style);
-							usel->m_used = true;
+							add_style(*usel.m_selector->m_style);
+							usel.m_used = true;
 						}
 					}
 				} else if(apply & select_match_with_after)
 				{
-					element::ptr el = get_element_after(*usel->m_selector->m_style, false);
+					element::ptr el = get_element_after(*usel.m_selector->m_style, false);
 					if(el)
 					{
-						el->add_style(*usel->m_selector->m_style);
+						el->add_style(*usel.m_selector->m_style);
 					}
 				} else if(apply & select_match_with_before)
 				{
-					element::ptr el = get_element_before(*usel->m_selector->m_style, false);
+					element::ptr el = get_element_before(*usel.m_selector->m_style, false);
 					if(el)
 					{
-						el->add_style(*usel->m_selector->m_style);
+						el->add_style(*usel.m_selector->m_style);
 					}
 				} else
 				{
-					add_style(*usel->m_selector->m_style);
-					usel->m_used = true;
+					add_style(*usel.m_selector->m_style);
+					usel.m_used = true;
 				}
 			}
 		}
@@ -1551,6 +1592,13 @@ string html_tag::dump_get_name()
 	return _s(m_tag) + " [html_tag]";
 }
 
+void html_tag::add_memory_usage(document_memory_usage& usage) const
+{
+	usage.element_bytes += heap_size(m_str_classes) + heap_size(m_classes) + heap_size(m_attrs) + heap_size(m_pseudo_classes);
+	usage.style_bytes += m_style.memory_usage();
+	add_element_memory_usage(usage, m_tag == empty_id ? "#anonymous" : _s(m_tag), sizeof(html_tag));
+}
+
 // https://html.spec.whatwg.org/multipage/rendering.html#maps-to-the-pixel-length-property
 void html_tag::map_to_pixel_length_property(string_id prop_name, string attr_value)
 {
@@ -7,168 +7,150 @@
 
 //////////////////////////////////////////////////////////////////////////////////////////
 
-litehtml::line_box_item::~line_box_item() = default;
+litehtml::line_box_item::line_box_item(render_item* element, element_type type) :
+	m_element(element),
+	m_type(type)
+{
+	switch (m_type)
+	{
+		case type_inline_start:
+			m_pos.height = m_element->src_el()->css().get_font_metrics().height;
+			m_pos.width = m_element->content_offset_left();
+			break;
+		case type_inline_end:
+			m_pos.height = m_element->src_el()->css().get_font_metrics().height;
+			m_pos.width = m_element->content_offset_right();
+			break;
+		case type_inline_continue:
+			m_pos.height = m_element->src_el()->css().get_font_metrics().height;
+			m_pos.width = 0;
+			break;
+		default:
+			break;
+	}
+}
 
 void litehtml::line_box_item::place_to(pixel_t x, pixel_t y)
 {
-	m_element->pos().x = x + m_element->content_offset_left();
-	m_element->pos().y = y + m_element->content_offset_top();
+	switch (m_type)
+	{
+		case type_text_part:
+			m_element->pos().x = x + m_element->content_offset_left();
+			m_element->pos().y = y + m_element->content_offset_top();
+			break;
+		case type_inline_start:
+			m_pos.x = x + m_element->content_offset_left();
+			m_pos.y = y;
+			break;
+		default:
+			m_pos.x = x;
+			m_pos.y = y;
+			break;
+	}
 }
 
 litehtml::position& litehtml::line_box_item::pos()
 {
-	return m_element->pos();
+	if(m_type == type_text_part)
+	{
+		return m_element->pos();
+	}
+	return m_pos;
 }
 
-
 litehtml::pixel_t litehtml::line_box_item::width() const
 {
-	return m_element->width();
+	switch (m_type)
+	{
+		case type_text_part:
+			return m_element->width();
+		case type_inline_continue:
+			return 0;
+		default:
+			return m_pos.width;
+	}
 }
 
 litehtml::pixel_t litehtml::line_box_item::top() const
 {
-	return m_element->top();
+	if(m_type == type_text_part)
+	{
+		return m_element->top();
+	}
+	return m_pos.y;
 }
 
 litehtml::pixel_t litehtml::line_box_item::bottom() const
 {
-	return m_element->bottom();
+	if(m_type == type_text_part)
+	{
+		return m_element->bottom();
+	}
+	return m_pos.y + m_pos.height;
 }
 
 litehtml::pixel_t litehtml::line_box_item::right() const
 {
-	return m_element->right();
+	switch (m_type)
+	{
+		case type_text_part:
+			return m_element->right();
+		case type_inline_end:
+			return m_pos.x + m_pos.width;
+		default:
+			return m_pos.x;
+	}
 }
 
 litehtml::pixel_t litehtml::line_box_item::left() const
 {
-	return m_element->left();
+	switch (m_type)
+	{
+		case type_text_part:
+			return m_element->left();
+		case type_inline_start:
+			return m_pos.x - m_element->content_offset_left();
+		default:
+			return m_pos.x;
+	}
 }
 
 litehtml::pixel_t litehtml::line_box_item::height() const
 {
-	return m_element->height();
-}
-
-void litehtml::line_box_item::y_shift(pixel_t shift)
-{
-	m_element->y_shift(shift);
-}
-
-//////////////////////////////////////////////////////////////////////////////////////////
-
-litehtml::lbi_start::lbi_start(const std::shared_ptr<render_item>& element) : line_box_item(element)
-{
-	m_pos.height = m_element->src_el()->css().get_font_metrics().height;
-	m_pos.width = m_element->content_offset_left();
-}
-
-litehtml::lbi_start::~lbi_start() = default;
-
-void litehtml::lbi_start::place_to(pixel_t x, pixel_t y)
-{
-	m_pos.x = x + m_element->content_offset_left();
-	m_pos.y = y;
-}
-
-litehtml::pixel_t litehtml::lbi_start::width() const
-{
-	return m_pos.width;
-}
-
-litehtml::pixel_t litehtml::lbi_start::top() const
-{
-	return m_pos.y;
-}
-
-litehtml::pixel_t litehtml::lbi_start::bottom() const
-{
-	return m_pos.y + m_pos.height;
-}
-
-litehtml::pixel_t litehtml::lbi_start::right() const
-{
-	return m_pos.x;
-}
-
-litehtml::pixel_t litehtml::lbi_start::left() const
-{
-	return m_pos.x - m_element->content_offset_left();
-}
-
-litehtml::pixel_t litehtml::lbi_start::height() const
-{
+	if(m_type == type_text_part)
+	{
+		return m_element->height();
+	}
 	return m_pos.height;
 }
 
-//////////////////////////////////////////////////////////////////////////////////////////
-
-litehtml::lbi_end::lbi_end(const std::shared_ptr<render_item>& element) : lbi_start(element)
-{
-	m_pos.height = m_element->src_el()->css().get_font_metrics().height;
-	m_pos.width = m_element->content_offset_right();
-}
-
-litehtml::lbi_end::~lbi_end() = default;
-
-void litehtml::lbi_end::place_to(pixel_t x, pixel_t y)
-{
-	m_pos.x = x;
-	m_pos.y = y;
-}
-
-litehtml::pixel_t litehtml::lbi_end::right() const
-{
-	return m_pos.x + m_pos.width;
-}
-
-litehtml::pixel_t litehtml::lbi_end::left() const
-{
-	return m_pos.x;
-}
-
-//////////////////////////////////////////////////////////////////////////////////////////
-
-litehtml::lbi_continue::lbi_continue(const std::shared_ptr<render_item>& element) : lbi_start(element)
-{
-	m_pos.height = m_element->src_el()->css().get_font_metrics().height;
-	m_pos.width = 0;
-}
-
-litehtml::lbi_continue::~lbi_continue() = default;
-
-void litehtml::lbi_continue::place_to(pixel_t x, pixel_t y)
-{
-	m_pos.x = x;
-	m_pos.y = y;
-}
-
-litehtml::pixel_t litehtml::lbi_continue::right() const
-{
-	return m_pos.x;
-}
-
-litehtml::pixel_t litehtml::lbi_continue::left() const
+litehtml::pixel_t litehtml::line_box_item::get_rendered_min_width() const
 {
-	return m_pos.x;
+	if(m_type == type_text_part)
+	{
+		return m_rendered_min_width;
+	}
+	return width();
 }
 
-litehtml::pixel_t litehtml::lbi_continue::width() const
+void litehtml::line_box_item::y_shift(pixel_t shift)
 {
-	return 0;
+	if(m_type != type_inline_end)
+	{
+		m_element->y_shift(shift);
+	}
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////
 
-void litehtml::line_box::add_item(std::unique_ptr<line_box_item> item)
+void litehtml::line_box::add_item(line_box_item item)
 {
-    item->get_el()->skip(false);
+    item.get_el()->skip(false);
     bool add	= true;
-	switch (item->get_type())
+	switch (item.get_type())
 	{
 		case line_box_item::type_text_part:
-			if(item->get_el()->src_el()->is_white_space())
+			if(item.get_el()->src_el()->is_white_space())
 			{
 				add = !is_empty() && !have_last_space();
 			}
@@ -181,17 +163,18 @@ void litehtml::line_box::add_item(std::unique_ptr<line_box_item> item)
 	}
 	if(add)
 	{
-		item->place_to(m_left + m_width, m_top);
-		m_width += item->width();
-		m_height = std::max(m_height, item->get_el()->height());
-		m_items.emplace_back(std::move(item));
+		item.place_to(m_left + m_width, m_top);
+		m_width += item.width();
+		m_height = std::max(m_height, item.get_el()->height());
+		m_storage->m_items.push_back(item);
+		m_last++;
 	} else
 	{
-		item->get_el()->skip(true);
+		item.get_el()->skip(true);
 	}
 }
 
-litehtml::pixel_t litehtml::line_box::calc_va_baseline(const va_context& current, vertical_align va, const font_metrics& new_font, pixel_t top, pixel_t bottom)
+litehtml::pixel_t litehtml::line_box::calc_va_baseline(const line_box_storage::va_context& current, vertical_align va, const font_metrics& new_font, pixel_t top, pixel_t bottom)
 {
 	switch(va)
 	{
@@ -215,39 +198,42 @@ litehtml::pixel_t litehtml::line_box::calc_va_baseline(const va_context& current
 	}
 }
 
-std::list< std::unique_ptr<litehtml::line_box_item> > litehtml::line_box::finish(bool last_box, const containing_block_context &containing_block_size)
+void litehtml::line_box::finish(bool last_box, const containing_block_context &containing_block_size, line_box_item::vector& next_items)
 {
-	std::list< std::unique_ptr<line_box_item> > ret_items;
-	bool									  finished_with_break = false;
+	auto& items = m_storage->m_items;
+	bool finished_with_break = false;
 
 	if(!last_box)
 	{
 		if(!is_empty())
 		{
-			finished_with_break = m_items.back()->get_el()->src_el()->is_break();
+			finished_with_break = items[m_last - 1].get_el()->src_el()->is_break();
 		}
-		while(!m_items.empty())
+		while(m_last > m_first)
 		{
-			if (m_items.back()->get_type() == line_box_item::type_text_part)
+			line_box_item& last_item = items[m_last - 1];
+			if (last_item.get_type() == line_box_item::type_text_part)
 			{
 				// remove trailing spaces
-				if (m_items.back()->get_el()->src_el()->is_break() ||
-					m_items.back()->get_el()->src_el()->is_white_space())
+				if (last_item.get_el()->src_el()->is_break() ||
+					last_item.get_el()->src_el()->is_white_space())
 				{
-					m_width -= m_items.back()->width();
-					m_items.back()->get_el()->skip(true);
-					m_items.pop_back();
+					m_width -= last_item.width();
+					last_item.get_el()->skip(true);
+					items.pop_back();
+					m_last--;
 				} else
 				{
 					break;
 				}
-			} else if (m_items.back()->get_type() == line_box_item::type_inline_start)
+			} else if (last_item.get_type() == line_box_item::type_inline_start)
 			{
 				// remove trailing empty inline_start markers
 				// these markers will be added at the beginning of the next line box
-				m_width -= m_items.back()->width();
-				ret_items.emplace_back(std::move(m_items.back()));
-				m_items.pop_back();
+				m_width -= last_item.width();
+				next_items.push_back(last_item);
+				items.pop_back();
+				m_last--;
 			} else
 			{
 				break;
@@ -256,40 +242,31 @@ std::list< std::unique_ptr<litehtml::line_box_item> > litehtml::line_box::finish
 	} else
 	{
 		// remove trailing spaces
-		auto iter = m_items.rbegin();
-		while(iter != m_items.rend())
+		size_t idx = m_last;
+		while(idx > m_first)
 		{
-			if ((*iter)->get_type() == line_box_item::type_text_part)
+			idx--;
+			line_box_item& item = items[idx];
+			if (item.get_type() == line_box_item::type_text_part)
 			{
-				if((*iter)->get_el()->src_el()->is_white_space())
+				if(item.get_el()->src_el()->is_white_space())
 				{
-					(*iter)->get_el()->skip(true);
-					m_width -= (*iter)->width();
+					item.get_el()->skip(true);
+					const pixel_t space_width = item.width();
+					m_width -= space_width;
 					// Space can be between text and inline_end marker
 					// We have to shift all items on the right side
-					if(iter != m_items.rbegin())
+					for(size_t right_idx = idx + 1; right_idx < m_last; right_idx++)
 					{
-						auto r_iter = iter;
-						r_iter--;
-						while (true)
-						{
-							(*r_iter)->pos().x -= (*iter)->width();
-							if (r_iter == m_items.rbegin())
-							{
-								break;
-							}
-							r_iter--;
-						}
+						items[right_idx].pos().x -= space_width;
 					}
 					// erase white space element
-					iter = decltype(iter) (m_items.erase( std::next(iter).base() ));
+					items.erase(items.begin() + (std::ptrdiff_t) idx);
+					m_last--;
 				} else
 				{
 					break;
 				}
-			} else
-			{
-				iter++;
 			}
 		}
 	}
@@ -298,7 +275,7 @@ std::list< std::unique_ptr<litehtml::line_box_item> > litehtml::line_box::finish
     {
         m_height = m_default_line_height.computed_value;
 		m_baseline = m_font_metrics.base_line();
-        return ret_items;
+        return;
     }
 
     pixel_t spacing_x = 0;	// Number of pixels to distribute between elements
@@ -330,7 +307,8 @@ std::list< std::unique_ptr<litehtml::line_box_item> > litehtml::line_box::finish
     }
 
     int counter = 0;
-    float offj  = float(spacing_x) / std::max(1.f, float(m_items.size()) - 1.f);
+    const int items_num = (int) items_count();
+    float offj  = float(spacing_x) / std::max(1.f, float(items_num) - 1.f);
     float cixx  = 0.0f;
 
 	std::optional<pixel_t> line_height;
@@ -340,8 +318,9 @@ std::list< std::unique_ptr<litehtml::line_box_item> > litehtml::line_box::finish
 		line_height = m_default_line_height.computed_value;
 	}
 
-	va_context current_context;
-	std::list<va_context> contexts;
+	line_box_storage::va_context current_context;
+	auto& contexts = m_storage->m_contexts;
+	contexts.clear();
 
 	current_context.baseline = 0;
 	current_context.fm = m_font_metrics;
@@ -357,11 +336,11 @@ std::list< std::unique_ptr<litehtml::line_box_item> > litehtml::line_box::finish
 		int count = 0;
 		pixel_t max_height = 0;
 
-		void add_item(const line_box_item* item)
+		void add_item(const line_box_item& item)
 		{
-			top = std::min(top, item->top());
-			bottom = std::max(bottom, item->bottom());
-			max_height = std::max(max_height, item->height());
+			top = std::min(top, item.top());
+			bottom = std::max(bottom, item.bottom());
+			max_height = std::max(max_height, item.height());
 			count++;
 		}
 		pixel_t height() const { return bottom - top; }
@@ -378,7 +357,7 @@ std::list< std::unique_ptr<litehtml::line_box_item> > litehtml::line_box::finish
 	// 2. top/button aligned items are aligned by baseline
 	// 3. Calculate top and button of the linebox separately for items in baseline
 	//    and for top and bottom aligned items
-    for (const auto& lbi : m_items)
+    for (line_box_item* lbi = items_begin(); lbi != items_end(); lbi++)
 	{
 		// Apply text-align-justify
 		m_rendered_width.natural_width += lbi->get_rendered_min_width();
@@ -386,12 +365,12 @@ std::list< std::unique_ptr<litehtml::line_box_item> > litehtml::line_box::finish
 		if (spacing_x != 0 && counter)
 		{
 			cixx += offj;
-			if ((counter + 1) == int(m_items.size()))
+			if ((counter + 1) == items_num)
 				cixx += 0.99f;
 			lbi->pos().x += (pixel_t) cixx;
 		}
 		counter++;
-		if ((m_text_align == text_align_right || spacing_x != 0) && counter == int(m_items.size()))
+		if ((m_text_align == text_align_right || spacing_x != 0) && counter == items_num)
 		{
 			// Forcible justify the last element to the right side for text align right and justify;
 			lbi->pos().x = m_right - lbi->pos().width;
@@ -409,7 +388,7 @@ std::list< std::unique_ptr<litehtml::line_box_item> > litehtml::line_box::finish
 			{
 				// top/bottom aligned inline boxes are aligned by baseline == 0
 				current_context.baseline = 0;
-				current_context.start_lbi = lbi.get();
+				current_context.start_lbi = lbi;
 				current_context.start_lbi->reset_items_height();
 			} else if(current_context.start_lbi)
 			{
@@ -481,10 +460,10 @@ std::list< std::unique_ptr<litehtml::line_box_item> > litehtml::line_box::finish
 			switch (lbi->get_el()->css().get_vertical_align())
 			{
 				case va_top:
-					top_aligned_max_height.add_item(lbi.get());
+					top_aligned_max_height.add_item(*lbi);
 					break;
 				case va_bottom:
-					bottom_aligned_max_height.add_item(lbi.get());
+					bottom_aligned_max_height.add_item(*lbi);
 					break;
 				default:
 					break;
@@ -495,10 +474,10 @@ std::list< std::unique_ptr<litehtml::line_box_item> > litehtml::line_box::finish
 			switch (current_context.start_lbi->get_el()->css().get_vertical_align())
 			{
 				case va_top:
-					top_aligned_max_height.add_item(lbi.get());
+					top_aligned_max_height.add_item(*lbi);
 					break;
 				case va_bottom:
-					bottom_aligned_max_height.add_item(lbi.get());
+					bottom_aligned_max_height.add_item(*lbi);
 					break;
 				default:
 					break;
@@ -507,10 +486,10 @@ std::list< std::unique_ptr<litehtml::line_box_item> > litehtml::line_box::finish
 		{
 			if(!lbi->get_el()->src_el()->is_inline_box())
 			{
-				line_max_height.add_item(lbi.get());
+				line_max_height.add_item(*lbi);
 			} else
 			{
-				inline_boxes_dims.add_item(lbi.get());
+				inline_boxes_dims.add_item(*lbi);
 			}
 		}
 
@@ -603,16 +582,8 @@ std::list< std::unique_ptr<litehtml::line_box_item> > litehtml::line_box::finish
 		m_baseline = line_max_height.bottom;
 	}
 
-	struct inline_item_box
-	{
-		std::shared_ptr<render_item> element;
-		position box;
-
-		inline_item_box() = default;
-		explicit inline_item_box(const std::shared_ptr<render_item>& el) : element(el) {}
-	};
-
-	std::list<inline_item_box> inlines;
+	auto& inlines = m_storage->m_inlines;
+	inlines.clear();
 
 	contexts.clear();
 
@@ -625,7 +596,7 @@ std::list< std::unique_ptr<litehtml::line_box_item> > litehtml::line_box::finish
 	// 1. Vertical align top/bottom
 	// 2. Apply relative shift
 	// 3. Calculate inline boxes
-    for (const auto& lbi : m_items)
+    for (line_box_item* lbi = items_begin(); lbi != items_end(); lbi++)
     {
 		if(is_one_of(lbi->get_type(), line_box_item::type_inline_start, line_box_item::type_inline_continue))
 		{
@@ -635,11 +606,11 @@ std::list< std::unique_ptr<litehtml::line_box_item> > litehtml::line_box::finish
 			if(lbi->get_el()->css().get_vertical_align() == va_top)
 			{
 				current_context.baseline = m_top - lbi->get_items_top();
-				current_context.start_lbi = lbi.get();
+				current_context.start_lbi = lbi;
 			} else if(lbi->get_el()->css().get_vertical_align() == va_bottom)
 			{
 				current_context.baseline = m_top + m_height - lbi->get_items_bottom();
-				current_context.start_lbi = lbi.get();
+				current_context.start_lbi = lbi;
 			}
 		} else if(lbi->get_type() == line_box_item::type_inline_end)
 		{
@@ -695,18 +666,16 @@ std::list< std::unique_ptr<litehtml::line_box_item> > litehtml::line_box::finish
 
 	for(auto iter = inlines.rbegin(); iter != inlines.rend(); ++iter)
 	{
-		iter->box.width =  m_items.back()->right() - iter->box.x;
+		iter->box.width =  items_end()[-1].right() - iter->box.x;
 		iter->element->add_inline_box(iter->box);
 
-		ret_items.emplace_front(std::unique_ptr<line_box_item>(new lbi_continue(iter->element)));
+		next_items.emplace(next_items.begin(), iter->element, line_box_item::type_inline_continue);
 	}
-
-	return ret_items;
 }
 
-std::shared_ptr<litehtml::render_item> litehtml::line_box::get_first_text_part() const
+litehtml::render_item* litehtml::line_box::get_first_text_part() const
 {
-	for(const auto & item : m_items)
+	for(const line_box_item* item = items_begin(); item != items_end(); item++)
 	{
 		if(item->get_type() == line_box_item::type_text_part)
 		{
@@ -717,27 +686,28 @@ std::shared_ptr<litehtml::render_item> litehtml::line_box::get_first_text_part()
 }
 
 
-std::shared_ptr<litehtml::render_item> litehtml::line_box::get_last_text_part() const
+litehtml::render_item* litehtml::line_box::get_last_text_part() const
 {
-	for(auto iter = m_items.rbegin(); iter != m_items.rend(); iter++)
+	for(const line_box_item* item = items_end(); item != items_begin();)
 	{
-		if((*iter)->get_type() == line_box_item::type_text_part)
+		item--;
+		if(item->get_type() == line_box_item::type_text_part)
 		{
-			return (*iter)->get_el();
+			return item->get_el();
 		}
 	}
 	return nullptr;
 }
 
 
-bool litehtml::line_box::can_hold(const std::unique_ptr<line_box_item>& item, white_space ws) const
+bool litehtml::line_box::can_hold(const line_box_item& item, white_space ws) const
 {
-    if(!item->get_el()->src_el()->is_inline()) return false;
+    if(!item.get_el()->src_el()->is_inline()) return false;
 
-	if(item->get_type() == line_box_item::type_text_part)
+	if(item.get_type() == line_box_item::type_text_part)
 	{
 		// force new line on floats clearing
-		if (item->get_el()->src_el()->is_break() && item->get_el()->css().get_clear() != clear_none)
+		if (item.get_el()->src_el()->is_break() && item.get_el()->css().get_clear() != clear_none)
 		{
 			return false;
 		}
@@ -758,18 +728,18 @@ bool litehtml::line_box::can_hold(const std::unique_ptr<line_box_item>& item, wh
 		}
 
 		// line break should stay in current line box
-		if (item->get_el()->src_el()->is_break())
+		if (item.get_el()->src_el()->is_break())
 		{
 			return true;
 		}
 
 		if (ws == white_space_nowrap || ws == white_space_pre ||
-			(ws == white_space_pre_wrap && item->get_el()->src_el()->is_space()))
+			(ws == white_space_pre_wrap && item.get_el()->src_el()->is_space()))
 		{
 			return true;
 		}
 
-		if (m_left + m_width + item->width() > m_right)
+		if (m_left + m_width + item.width() > m_right)
 		{
 			return false;
 		}
@@ -790,14 +760,14 @@ bool litehtml::line_box::have_last_space()  const
 
 bool litehtml::line_box::is_empty() const
 {
-    if(m_items.empty()) return true;
-	if(m_items.size() == 1 &&
-		m_items.front()->get_el()->src_el()->is_break() &&
-		m_items.front()->get_el()->src_el()->css().get_clear() != clear_none)
+    if(m_last == m_first) return true;
+	if(items_count() == 1 &&
+		items_begin()->get_el()->src_el()->is_break() &&
+		items_begin()->get_el()->src_el()->css().get_clear() != clear_none)
 	{
 		return true;
 	}
-    for (const auto& el : m_items)
+    for (const line_box_item* el = items_begin(); el != items_end(); el++)
     {
 		if(el->get_type() == line_box_item::type_text_part)
 		{
@@ -828,7 +798,7 @@ litehtml::pixel_t litehtml::line_box::bottom_margin() const
 void litehtml::line_box::y_shift( pixel_t shift )
 {
 	m_top += shift;
-	for (auto& el : m_items)
+	for (line_box_item* el = items_begin(); el != items_end(); el++)
 	{
 		el->y_shift(shift);
 	}
@@ -836,18 +806,19 @@ void litehtml::line_box::y_shift( pixel_t shift )
 
 bool litehtml::line_box::is_break_only() const
 {
-    if(m_items.empty()) return false;
+    if(m_last == m_first) return false;
 
 	bool break_found = false;
 
-	for (auto iter = m_items.rbegin(); iter != m_items.rend(); iter++)
+	for(const line_box_item* item = items_end(); item != items_begin();)
 	{
-		if((*iter)->get_type() == line_box_item::type_text_part)
+		item--;
+		if(item->get_type() == line_box_item::type_text_part)
 		{
-			if((*iter)->get_el()->src_el()->is_break())
+			if(item->get_el()->src_el()->is_break())
 			{
 				break_found = true;
-			} else if(!(*iter)->get_el()->skip())
+			} else if(!item->get_el()->skip())
 			{
 				return false;
 			}
@@ -856,40 +827,43 @@ bool litehtml::line_box::is_break_only() const
 	return break_found;
 }
 
-std::list< std::unique_ptr<litehtml::line_box_item> > litehtml::line_box::new_width( pixel_t left, pixel_t right)
+void litehtml::line_box::new_width( pixel_t left, pixel_t right, line_box_item::vector& removed_items)
 {
-	std::list< std::unique_ptr<line_box_item> > ret_items;
     pixel_t add = left - m_left;
     if(add != 0)
     {
 		m_left	= left;
 		m_right	= right;
         m_width = 0;
-        auto remove_begin = m_items.end();
-		auto i = m_items.begin();
-		i++;
-		while (i != m_items.end())
+        size_t remove_begin = m_last;
+		for (size_t i = m_first + 1; i < m_last; i++)
         {
-            if(!(*i)->get_el()->skip())
+			line_box_item& item = m_storage->m_items[i];
+            if(!item.get_el()->skip())
             {
-                if(m_left + m_width + (*i)->width() > m_right)
+                if(m_left + m_width + item.width() > m_right)
                 {
                     remove_begin = i;
                     break;
                 }
-				(*i)->pos().x += add;
-				m_width += (*i)->get_el()->width();
+				item.pos().x += add;
+				m_width += item.get_el()->width();
             }
-			i++;
         }
-        if(remove_begin != m_items.end())
+        if(remove_begin != m_last)
         {
-			while(remove_begin != m_items.end())
-			{
-				ret_items.emplace_back(std::move(*remove_begin));
-			}
-            m_items.erase(remove_begin, m_items.end());
+			auto& items = m_storage->m_items;
+			removed_items.insert(removed_items.end(), items.begin() + (std::ptrdiff_t) remove_begin, items.begin() + (std::ptrdiff_t) m_last);
+			items.erase(items.begin() + (std::ptrdiff_t) remove_begin, items.begin() + (std::ptrdiff_t) m_last);
+			m_last = remove_begin;
         }
     }
-	return ret_items;
+}
+
+void litehtml::line_box::release_items(line_box_item::vector& items)
+{
+	auto& storage_items = m_storage->m_items;
+	items.insert(items.end(), storage_items.begin() + (std::ptrdiff_t) m_first, storage_items.begin() + (std::ptrdiff_t) m_last);
+	storage_items.erase(storage_items.begin() + (std::ptrdiff_t) m_first, storage_items.begin() + (std::ptrdiff_t) m_last);
+	m_last = m_first;
 }
@@ -0,0 +1,77 @@
+#include "memory_usage.h"
+#include "css_selector.h"
+#include "background.h"
+
+size_t litehtml::heap_size(const string& str)
+{
+	// short strings are stored inside the object
+	const char* data = str.data();
+	if(data >= (const char*) &str && data < (const char*) (&str + 1))
+	{
+		return 0;
+	}
+	return str.capacity() + 1;
+}
+
+size_t litehtml::heap_size(const image& img)
+{
+	return heap_size(img.url) + heap_size(img.m_gradient.m_colors);
+}
+
+size_t litehtml::heap_size(const background& bg)
+{
+	return	heap_size(bg.m_image) +
+			heap_size(bg.m_baseurl) +
+			heap_size(bg.m_attachment) +
+			heap_size(bg.m_position_x) +
+			heap_size(bg.m_position_y) +
+			heap_size(bg.m_size) +
+			heap_size(bg.m_repeat) +
+			heap_size(bg.m_clip) +
+			heap_size(bg.m_origin);
+}
+
+size_t litehtml::heap_size(const css_token& token)
+{
+	size_t ret = heap_size(token.str) + heap_size(token.repr);
+	if(token.is_component_value())
+	{
+		ret += heap_size(token.value);
+	}
+	return ret;
+}
+
+size_t litehtml::heap_size(const property_value& val)
+{
+	if(val.is<int_vector>())		return heap_size(val.get<int_vector>());
+	if(val.is<length_vector>())		return heap_size(val.get<length_vector>());
+	if(val.is<vector<image>>())		return heap_size(val.get<vector<image>>());
+	if(val.is<string>())			return heap_size(val.get<string>());
+	if(val.is<string_vector>())		return heap_size(val.get<string_vector>());
+	if(val.is<size_vector>())		return heap_size(val.get<size_vector>());
+	if(val.is<css_token_vector>())	return heap_size(val.get<css_token_vector>());
+	return 0;
+}
+
+size_t litehtml::heap_size(const style& st)
+{
+	return st.memory_usage();
+}
+
+size_t litehtml::heap_size(const css_selector& selector)
+{
+	size_t ret = selector.m_right.m_attrs.capacity() * sizeof(css_attribute_selector);
+	for(const auto& attr : selector.m_right.m_attrs)
+	{
+		ret += heap_size(attr.value) + attr.selector_list.capacity() * sizeof(css_selector::ptr);
+		for(const auto& sel : attr.selector_list)
+		{
+			ret += sizeof(css_selector) + shared_count_size + heap_size(*sel);
+		}
+	}
+	if(selector.m_left)
+	{
+		ret += sizeof(css_selector) + shared_count_size + heap_size(*selector.m_left);
+	}
+	return ret;
+}
@@ -188,12 +188,24 @@ litehtml::rendered_width litehtml::render_item_block::_render(pixel_t x, pixel_t
 															  const containing_block_context& containing_block_size,
 															  formatting_context* fmt_ctx, bool second_pass)
 {
+	LH_TRACE_SCOPE(src_el()->get_document()->get_trace_sink(), "render_item_block::_render", src_el().get());
 	containing_block_context self_size = calculate_containing_block_context(containing_block_size);
 
+	// The lazy layout stopped in the second pass continues in the second pass with the same width
+	pixel_t continued_width = 0;
+	bool continued_second_pass = false;
+	if(const auto* stopped = fmt_ctx->find_continued_block(this))
+	{
+		continued_width = stopped->width;
+		continued_second_pass = stopped->second_pass && !second_pass;
+	}
+
     //*****************************************
     // Render content
     //*****************************************
-	auto [ret_width, ret_min_width] = _render_content(x, y, second_pass, self_size, fmt_ctx);
+	auto [ret_width, ret_min_width] = continued_second_pass ?
+		_render_content(x, y, true, self_size.new_width(continued_width), fmt_ctx) :
+		_render_content(x, y, second_pass, self_size, fmt_ctx);
 	//*****************************************
 
 	if (src_el()->css().get_display() == display_list_item)
@@ -249,8 +261,13 @@ litehtml::rendered_width litehtml::render_item_block::_render(pixel_t x, pixel_t
 	}
 
 	// re-render content with new width if required
-	if (requires_rerender && !second_pass && !is_root())
+	if (requires_rerender && !second_pass && !is_root() && !continued_second_pass)
 	{
+		if(fmt_ctx->is_layout_stopped())
+		{
+			// The content is laid out from the top again, the lazy layout stops in it again
+			fmt_ctx->restart_layout();
+		}
 		if(src_el()->is_block_formatting_context())
 		{
 			fmt_ctx->clear_floats(-1);
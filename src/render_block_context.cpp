@@ -7,16 +7,86 @@ litehtml::rendered_width litehtml::render_item_block_context::_render_content(pi
 																			  const containing_block_context& self_size,
 																			  formatting_context*			  fmt_ctx)
 {
+	LH_TRACE_SCOPE(src_el()->get_document()->get_trace_sink(), "render_item_block_context::_render_content", src_el().get());
 	std::shared_ptr<render_item> last_margin_el;
 
 	rendered_width ret_width;
 	pixel_t		   child_top   = 0;
 	pixel_t		   last_margin = 0;
 	bool		   is_first	   = true;
+	int			   laid_out	   = 0; // number of the in-flow children laid out
+	int			   pending	   = 0; // number of the in-flow children left for the lazy layout
+	size_t		   first_child = 0; // the children before it were laid out by the stopped lazy layout
+	bool		   continued   = false;
+
+	formatting_context::stopped_block stopped;
+	if(fmt_ctx->take_continued_block(this, stopped))
+	{
+		if(stopped.width == self_size.width && stopped.second_pass == second_pass)
+		{
+			first_child		= stopped.child;
+			child_top		= stopped.child_top;
+			m_margins.top	= stopped.top_margin;
+			last_margin		= stopped.last_margin;
+			last_margin_el	= std::move(stopped.last_margin_el);
+			is_first		= stopped.is_first;
+			laid_out		= stopped.laid_out;
+			ret_width		= stopped.ret_width;
+			continued		= true;
+			// The stopped layout collapsed the bottom margin of its last child with this block
+			if(last_margin_el)
+			{
+				last_margin_el->get_margins().bottom = last_margin;
+			}
+		} else
+		{
+			fmt_ctx->break_continuation();
+		}
+	}
+
+	// Saves the state before the child to continue the layout from it
+	auto save_stopped = [&](size_t child, pixel_t top)
+	{
+		formatting_context::stopped_block block;
+		block.el			= this;
+		block.child			= child;
+		block.width			= self_size.width;
+		block.second_pass	= second_pass;
+		block.child_top		= top;
+		block.top_margin	= m_margins.top;
+		block.last_margin	= last_margin;
+		block.last_margin_el = last_margin_el;
+		block.is_first		= is_first;
+		block.laid_out		= laid_out;
+		block.ret_width		= ret_width;
+		fmt_ctx->add_stopped_block(std::move(block));
+	};
+
+	size_t child_idx = 0;
 	for(const auto& el : m_children)
 	{
-		// we don't need to process absolute and fixed positioned element on the second pass
-		if(second_pass)
+		size_t cur_child = child_idx++;
+		if(cur_child < first_child)
+		{
+			continue;
+		}
+		// Nothing is laid out after the layout stopped, so it can continue from the stopped blocks
+		if(pending || fmt_ctx->is_layout_stopped())
+		{
+			el->layout_pending(true);
+			if(el->src_el()->css().get_float() == float_none && el->src_el()->css().get_display() != display_none &&
+			   el->src_el()->css().get_position() != element_position_absolute &&
+			   el->src_el()->css().get_position() != element_position_fixed)
+			{
+				pending++;
+			}
+			continue;
+		}
+		el->layout_pending(false);
+
+		// we don't need to process absolute and fixed positioned element on the second pass,
+		// unless the first pass didn't lay them out before the lazy layout stopped
+		if(second_pass && !continued)
 		{
 			auto el_position = el->src_el()->css().get_position();
 			if((el_position == element_position_absolute || el_position == element_position_fixed))
@@ -39,7 +109,17 @@ litehtml::rendered_width litehtml::render_item_block_context::_render_content(pi
 				}
 			} else
 			{
+				pixel_t start_top	= child_top;
 				child_top			= fmt_ctx->get_cleared_top(el, child_top);
+				if(fmt_ctx->is_below_layout_limit(child_top))
+				{
+					// Stop the layout here, the rest of the children will be laid out on demand
+					save_stopped(cur_child, start_top);
+					el->layout_pending(true);
+					fmt_ctx->set_layout_stopped();
+					pending++;
+					continue;
+				}
 				pixel_t child_x		= 0;
 				pixel_t child_width = self_size.render_width;
 				pixel_t top_margin	= m_margins.top;
@@ -72,6 +152,11 @@ litehtml::rendered_width litehtml::render_item_block_context::_render_content(pi
 				}
 
 				auto rw = el->render(child_x, child_top, self_size.new_width(child_width), fmt_ctx);
+				if(fmt_ctx->is_layout_stopped())
+				{
+					// The layout stopped inside the child, it continues from the child
+					save_stopped(cur_child, start_top);
+				}
 				// Render table with "width: auto" into returned width
 				if(el->css().get_display() == display_table && rw.natural_width < child_width &&
 				   el->css().get_width().is_predefined())
@@ -121,6 +206,7 @@ litehtml::rendered_width litehtml::render_item_block_context::_render_content(pi
 				last_margin		= el->get_margins().bottom;
 				last_margin_el	= el;
 				is_first		= false;
+				laid_out++;
 
 				if(el->src_el()->css().get_position() == element_position_relative)
 				{
@@ -130,6 +216,12 @@ litehtml::rendered_width litehtml::render_item_block_context::_render_content(pi
 		}
 	}
 
+	if(pending && laid_out)
+	{
+		// Estimate the height of the pending children from the children laid out
+		child_top += child_top / (pixel_t) laid_out * (pixel_t) pending;
+	}
+
 	if(self_size.height.type != containing_block_context::cbc_value_type_auto && self_size.height > 0)
 	{
 		m_pos.height = self_size.height;
@@ -1,11 +1,13 @@
 #include "types.h"
 #include "render_flex.h"
 #include "html_tag.h"
+#include "document.h"
 
 litehtml::rendered_width litehtml::render_item_flex::_render_content(pixel_t x, pixel_t y, bool /*second_pass*/,
 																	 const containing_block_context& self_size,
 																	 formatting_context*			 fmt_ctx)
 {
+	LH_TRACE_SCOPE(src_el()->get_document()->get_trace_sink(), "render_item_flex::_render_content", src_el().get());
 	bool is_row_direction = true;
 	bool reverse = false;
 	pixel_t container_main_size = self_size.render_width;
@@ -6,6 +6,7 @@ litehtml::rendered_width litehtml::render_item_image::_render(pixel_t x, pixel_t
 															  const containing_block_context& containing_block_size,
 															  formatting_context* /*fmt_ctx*/, bool /*second_pass*/)
 {
+	LH_TRACE_SCOPE(src_el()->get_document()->get_trace_sink(), "render_item_image::_render", src_el().get());
     pixel_t parent_width = containing_block_size.width;
 	containing_block_context self_size = calculate_containing_block_context(containing_block_size);
 
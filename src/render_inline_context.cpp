@@ -7,7 +7,9 @@ litehtml::rendered_width litehtml::render_item_inline_context::_render_content(
 	pixel_t /*x*/, pixel_t /*y*/, bool /*second_pass*/, const containing_block_context& self_size,
 	formatting_context* fmt_ctx)
 {
+	LH_TRACE_SCOPE(src_el()->get_document()->get_trace_sink(), "render_item_inline_context::_render_content", src_el().get());
     m_line_boxes.clear();
+	m_line_box_storage.clear();
 	m_rendered_width.reset();
 
 	white_space ws			= src_el()->css().get_white_space();
@@ -49,20 +51,20 @@ litehtml::rendered_width litehtml::render_item_inline_context::_render_content(
 							}
 						}
 						// place element into rendering flow
-						place_inline(std::make_unique<line_box_item>(el), self_size, fmt_ctx);
+						place_inline(line_box_item(el.get(), line_box_item::type_text_part), self_size, fmt_ctx);
 					}
 					break;
 
 				case iterator_item_type_start_parent:
 					{
 						el->clear_inline_boxes();
-						place_inline(std::make_unique<lbi_start>(el), self_size, fmt_ctx);
+						place_inline(line_box_item(el.get(), line_box_item::type_inline_start), self_size, fmt_ctx);
 					}
 					break;
 
 				case iterator_item_type_end_parent:
 				{
-					place_inline(std::make_unique<lbi_end>(el), self_size, fmt_ctx);
+					place_inline(line_box_item(el.get(), line_box_item::type_inline_end), self_size, fmt_ctx);
 				}
 					break;
 			}
@@ -75,7 +77,7 @@ litehtml::rendered_width litehtml::render_item_inline_context::_render_content(
         if (collapse_top_margin())
         {
             pixel_t old_top = m_margins.top;
-            m_margins.top = std::max(m_line_boxes.front()->top_margin(), m_margins.top);
+            m_margins.top = std::max(m_line_boxes.front().top_margin(), m_margins.top);
             if (m_margins.top != old_top)
             {
                 fmt_ctx->update_floats(m_margins.top - old_top, shared_from_this());
@@ -83,12 +85,12 @@ litehtml::rendered_width litehtml::render_item_inline_context::_render_content(
         }
         if (collapse_bottom_margin())
         {
-            m_margins.bottom = std::max(m_line_boxes.back()->bottom_margin(), m_margins.bottom);
-            m_pos.height = m_line_boxes.back()->bottom() - m_line_boxes.back()->bottom_margin();
+            m_margins.bottom = std::max(m_line_boxes.back().bottom_margin(), m_margins.bottom);
+            m_pos.height = m_line_boxes.back().bottom() - m_line_boxes.back().bottom_margin();
         }
         else
         {
-            m_pos.height = m_line_boxes.back()->bottom();
+            m_pos.height = m_line_boxes.back().bottom();
         }
     }
 
@@ -101,9 +103,8 @@ void litehtml::render_item_inline_context::fix_line_width(element_float flt,
 {
     if(!m_line_boxes.empty())
     {
-		auto el_front = m_line_boxes.back()->get_first_text_part();
+		auto el_front = m_line_boxes.back().get_first_text_part();
 
-        std::vector<std::shared_ptr<render_item>> els;
         bool was_cleared = false;
         if(el_front && el_front->src_el()->css().get_clear() != clear_none)
         {
@@ -122,17 +123,18 @@ void litehtml::render_item_inline_context::fix_line_width(element_float flt,
 
         if(!was_cleared)
         {
-			std::list<std::unique_ptr<line_box_item> > items = std::move(m_line_boxes.back()->items());
+			line_box_item::vector items;
+			m_line_boxes.back().release_items(items);
             m_line_boxes.pop_back();
 
-            for(auto& item : items)
+            for(const auto& item : items)
             {
-                place_inline(std::move(item), self_size, fmt_ctx);
+                place_inline(item, self_size, fmt_ctx);
             }
         } else
         {
             pixel_t line_top = 0;
-            line_top = m_line_boxes.back()->top();
+            line_top = m_line_boxes.back().top();
 
             pixel_t line_left	= 0;
             pixel_t line_right	= self_size.render_width;
@@ -153,46 +155,46 @@ void litehtml::render_item_inline_context::fix_line_width(element_float flt,
 
             }
 
-            auto items = m_line_boxes.back()->new_width(line_left, line_right);
-            for(auto& item : items)
+            line_box_item::vector items;
+            m_line_boxes.back().new_width(line_left, line_right, items);
+            for(const auto& item : items)
             {
-                place_inline(std::move(item), self_size, fmt_ctx);
+                place_inline(item, self_size, fmt_ctx);
             }
         }
     }
 }
 
-std::list<std::unique_ptr<litehtml::line_box_item> > litehtml::render_item_inline_context::finish_last_box(bool end_of_render, const containing_block_context &self_size)
+void litehtml::render_item_inline_context::finish_last_box(bool end_of_render, const containing_block_context &self_size)
 {
-	std::list<std::unique_ptr<line_box_item> > ret;
+	m_next_line_items.clear();
 
     if(!m_line_boxes.empty())
     {
-		ret = m_line_boxes.back()->finish(end_of_render, self_size);
+		m_line_boxes.back().finish(end_of_render, self_size, m_next_line_items);
 
-        if(m_line_boxes.back()->is_empty() && end_of_render)
+        if(m_line_boxes.back().is_empty() && end_of_render)
         {
 			// remove the last empty line
             m_line_boxes.pop_back();
         } else
 		{
-			m_rendered_width.merge(m_line_boxes.back()->get_rendered_width());
+			m_rendered_width.merge(m_line_boxes.back().get_rendered_width());
 		}
 	}
-	return ret;
 }
 
-litehtml::pixel_t litehtml::render_item_inline_context::new_box(const std::unique_ptr<line_box_item>& el,
+litehtml::pixel_t litehtml::render_item_inline_context::new_box(line_box_item& el,
 																const containing_block_context&		  self_size,
 																formatting_context*					  fmt_ctx)
 {
-	auto items = finish_last_box(false, self_size);
+	finish_last_box(false, self_size);
 	pixel_t line_top = 0;
 	if(!m_line_boxes.empty())
 	{
-		line_top = m_line_boxes.back()->bottom();
+		line_top = m_line_boxes.back().bottom();
 	}
-	line_top = fmt_ctx->get_cleared_top(el->get_el(), line_top);
+	line_top = fmt_ctx->get_cleared_top(el.get_el()->shared_from_this(), line_top);
 
 	pixel_t first_line_margin = 0;
 	pixel_t text_indent		  = 0;
@@ -211,59 +213,59 @@ litehtml::pixel_t litehtml::render_item_inline_context::new_box(const std::uniqu
 
 	formatting_context::el_position el_pos;
 	el_pos.container_width	= self_size.render_width;
-	el_pos.el_pos			= el->pos();
+	el_pos.el_pos			= el.pos();
 	el_pos.el_pos.y			= line_top;
 	el_pos.el_pos.x			= 0;
 	el_pos.el_pos.width	   += text_indent + first_line_margin;
 	auto new_pos			= fmt_ctx->place_to_left(el_pos);
 
-	m_line_boxes.emplace_back(std::make_unique<line_box>(new_pos.top, new_pos.left + first_line_margin + text_indent,
-														 new_pos.left + new_pos.width, css().line_height(),
-														 css().get_font_metrics(), css().get_text_align()));
+	m_line_boxes.emplace_back(&m_line_box_storage, new_pos.top, new_pos.left + first_line_margin + text_indent,
+							  new_pos.left + new_pos.width, css().line_height(),
+							  css().get_font_metrics(), css().get_text_align());
 
 	// Add items returned by finish_last_box function into the new line
-	for(auto& it : items)
+	for(const auto& it : m_next_line_items)
 	{
-		m_line_boxes.back()->add_item(std::move(it));
+		m_line_boxes.back().add_item(it);
 	}
 
 	return new_pos.top;
 }
 
-void litehtml::render_item_inline_context::place_inline(std::unique_ptr<line_box_item>	item,
+void litehtml::render_item_inline_context::place_inline(line_box_item					item,
 														const containing_block_context& self_size,
 														formatting_context*				fmt_ctx)
 {
-    if(item->get_el()->src_el()->css().get_display() == display_none) return;
+    if(item.get_el()->src_el()->css().get_display() == display_none) return;
 
-    if(item->get_el()->src_el()->is_float())
+    if(item.get_el()->src_el()->is_float())
     {
         pixel_t line_top = 0;
         if(!m_line_boxes.empty())
         {
-            line_top = m_line_boxes.back()->top();
+            line_top = m_line_boxes.back().top();
         }
-		auto rw = place_float(item->get_el(), line_top, self_size, fmt_ctx);
+		auto rw = place_float(item.get_el()->shared_from_this(), line_top, self_size, fmt_ctx);
 		m_rendered_width.merge(rw);
 		return;
 	}
 
-	if(item->get_type() == line_box_item::type_text_part)
+	if(item.get_type() == line_box_item::type_text_part)
 	{
-		if(item->get_el()->src_el()->is_inline_box())
+		if(item.get_el()->src_el()->is_inline_box())
 		{
-			pixel_t min_rendered_width = item->get_el()->render(0, 0, self_size, fmt_ctx).natural_width;
-			if(min_rendered_width < item->get_el()->width() && item->get_el()->src_el()->css().get_width().is_predefined())
+			pixel_t min_rendered_width = item.get_el()->render(0, 0, self_size, fmt_ctx).natural_width;
+			if(min_rendered_width < item.get_el()->width() && item.get_el()->src_el()->css().get_width().is_predefined())
 			{
-				item->get_el()->render(0, 0, self_size.new_width(min_rendered_width), fmt_ctx);
+				item.get_el()->render(0, 0, self_size.new_width(min_rendered_width), fmt_ctx);
 			}
-			item->set_rendered_min_width(min_rendered_width);
-		} else if(item->get_el()->src_el()->css().get_display() == display_inline_text)
+			item.set_rendered_min_width(min_rendered_width);
+		} else if(item.get_el()->src_el()->css().get_display() == display_inline_text)
 		{
 			litehtml::size sz;
-			item->get_el()->src_el()->get_content_size(sz, self_size.render_width);
-			item->get_el()->pos() = sz;
-			item->set_rendered_min_width(sz.width);
+			item.get_el()->src_el()->get_content_size(sz, self_size.render_width);
+			item.get_el()->pos() = sz;
+			item.set_rendered_min_width(sz.width);
 		}
 	}
 
@@ -271,7 +273,7 @@ void litehtml::render_item_inline_context::place_inline(std::unique_ptr<line_box
 
 	if(!m_line_boxes.empty())
 	{
-		if(m_line_boxes.back()->can_hold(item, src_el()->css().get_white_space()))
+		if(m_line_boxes.back().can_hold(item, src_el()->css().get_white_space()))
 		{
 			add_box = false;
 		}
@@ -281,38 +283,38 @@ void litehtml::render_item_inline_context::place_inline(std::unique_ptr<line_box
 		new_box(item, self_size, fmt_ctx);
 	}
 
-	if(!item->get_el()->src_el()->is_inline())
+	if(!item.get_el()->src_el()->is_inline())
 	{
 		if(m_line_boxes.size() == 1)
 		{
 			if(collapse_top_margin())
 			{
-				pixel_t shift = item->get_el()->margin_top();
+				pixel_t shift = item.get_el()->margin_top();
 				if(shift >= 0)
 				{
-					m_line_boxes.back()->y_shift(-shift);
+					m_line_boxes.back().y_shift(-shift);
 				}
 			}
 		} else
 		{
 			pixel_t shift		= 0;
-			pixel_t prev_margin = m_line_boxes[m_line_boxes.size() - 2]->bottom_margin();
+			pixel_t prev_margin = m_line_boxes[m_line_boxes.size() - 2].bottom_margin();
 
-			if(prev_margin > item->get_el()->margin_top())
+			if(prev_margin > item.get_el()->margin_top())
 			{
-				shift = item->get_el()->margin_top();
+				shift = item.get_el()->margin_top();
 			} else
 			{
 				shift = prev_margin;
 			}
 			if(shift >= 0)
 			{
-				m_line_boxes.back()->y_shift(-shift);
+				m_line_boxes.back().y_shift(-shift);
 			}
 		}
 	}
 
-	m_line_boxes.back()->add_item(std::move(item));
+	m_line_boxes.back().add_item(item);
 }
 
 void litehtml::render_item_inline_context::apply_vertical_align()
@@ -320,7 +322,7 @@ void litehtml::render_item_inline_context::apply_vertical_align()
 	if(!m_line_boxes.empty())
 	{
 		pixel_t add			   = 0;
-		pixel_t content_height = m_line_boxes.back()->bottom();
+		pixel_t content_height = m_line_boxes.back().bottom();
 
 		if(m_pos.height > content_height)
 		{
@@ -342,7 +344,7 @@ void litehtml::render_item_inline_context::apply_vertical_align()
         {
             for(auto & box : m_line_boxes)
             {
-                box->y_shift(add);
+                box.y_shift(add);
             }
         }
     }
@@ -354,7 +356,7 @@ litehtml::pixel_t litehtml::render_item_inline_context::get_first_baseline()
 	if(!m_line_boxes.empty())
 	{
 		const auto &line = m_line_boxes.front();
-		bl = line->bottom() - line->baseline() + content_offset_top();
+		bl = line.bottom() - line.baseline() + content_offset_top();
 	} else
 	{
 		bl = height() - margin_bottom();
@@ -368,10 +370,18 @@ litehtml::pixel_t litehtml::render_item_inline_context::get_last_baseline()
 	if(!m_line_boxes.empty())
 	{
 		const auto &line = m_line_boxes.back();
-		bl = line->bottom() - line->baseline() + content_offset_top();
+		bl = line.bottom() - line.baseline() + content_offset_top();
 	} else
 	{
 		bl = height();
 	}
 	return bl;
 }
+
+void litehtml::render_item_inline_context::add_memory_usage(document_memory_usage& usage) const
+{
+	render_item_block::add_memory_usage(usage);
+	usage.render_item_bytes += sizeof(render_item_inline_context) - sizeof(render_item);
+	usage.line_boxes += m_line_boxes.size();
+	usage.line_box_bytes += heap_size(m_line_boxes) + m_line_box_storage.memory_usage() + heap_size(m_next_line_items);
+}
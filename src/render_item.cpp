@@ -6,7 +6,10 @@
 
 litehtml::render_item::render_item(std::shared_ptr<element>  _src_el) :
         m_element(std::move(_src_el)),
-        m_skip(false)
+        m_skip(false),
+        m_layout_pending(false),
+        m_has_static_pos(false),
+        m_render_calls(0)
 {
     document::ptr doc = src_el()->get_document();
 	auto fm = css().get_font_metrics();
@@ -31,6 +34,9 @@ litehtml::rendered_width litehtml::render_item::render(pixel_t x, pixel_t y,
 													   const containing_block_context& containing_block_size,
 													   formatting_context* fmt_ctx, bool second_pass)
 {
+	LH_TRACE_SCOPE(src_el()->get_document()->get_trace_sink(), "render_item::render", src_el().get());
+	m_render_calls++;
+	m_has_static_pos = false;
 	calc_outlines(containing_block_size.width);
 
 	m_pos.clear();
@@ -43,6 +49,15 @@ litehtml::rendered_width litehtml::render_item::render(pixel_t x, pixel_t y,
 	m_pos.y += content_top;
 
 
+	if(is_root() && fmt_ctx)
+	{
+		// The document's context is the root formatting context, the document keeps it with the floats
+		// to continue the lazy layout
+		auto ret = _render(x, y, containing_block_size, fmt_ctx, second_pass);
+		fmt_ctx->apply_relative_shift(containing_block_size);
+		return ret;
+	}
+
 	if(src_el()->is_block_formatting_context() || ! fmt_ctx)
 	{
 		formatting_context fmt;
@@ -223,6 +238,10 @@ bool litehtml::render_item::fetch_positioned()
 
     for(auto& el : m_children)
     {
+        if(el->layout_pending())
+        {
+            continue;
+        }
         el_pos = el->src_el()->css().get_position();
         if (el_pos != element_position_static)
         {
@@ -343,9 +362,16 @@ void litehtml::render_item::render_positioned(render_type rt)
 			pixel_t bottom = 0;
 			pixel_t top = 0;
 			pixel_t height = 0;
+			// The static position is taken once after the element is laid out in the flow. The continued lazy
+			// layout positions the elements again without laying them out in the flow.
+			if(!el->m_has_static_pos)
+			{
+				el->m_static_pos.set(el->m_pos.x, el->m_pos.y);
+				el->m_has_static_pos = true;
+			}
 			auto [el_static_offset_x, el_static_offset_y] = element_static_offset(el);
-			pixel_t el_static_x = el->m_pos.x + el_static_offset_x;
-			pixel_t el_static_y = el->m_pos.y + el_static_offset_y;
+			pixel_t el_static_x = el->m_static_pos.x + el_static_offset_x;
+			pixel_t el_static_y = el->m_static_pos.y + el_static_offset_y;
 			// Calculate vertical position
 			// https://www.w3.org/TR/CSS22/visudet.html#abs-non-replaced-height
 			// 10.6.4 Absolutely positioned, non-replaced elements
@@ -643,6 +669,7 @@ void litehtml::render_item::render_positioned(render_type rt)
                 position pos = el->m_pos;
 				el->render(el->left(), el->top(), containing_block_size.new_width(el->width()), nullptr, true);
                 el->m_pos = pos;
+                el->m_has_static_pos = true;
             }
 
             if(el_position == element_position_fixed)
@@ -768,21 +795,15 @@ void litehtml::render_item::calc_document_size(litehtml::size& sz, pixel_t x /*=
 void litehtml::render_item::draw_stacking_context( uint_ptr hdc, pixel_t x, pixel_t y, const position* clip, bool with_positioned )
 {
     if(!is_visible()) return;
+	LH_TRACE_SCOPE(src_el()->get_document()->get_trace_sink(), "render_item::draw_stacking_context", src_el().get());
 
-    std::map<int, bool> z_indexes;
+    const auto& z_indexes = m_paint_order.z_indexes;
+    auto z_zero = std::lower_bound(z_indexes.begin(), z_indexes.end(), 0);
     if(with_positioned)
     {
-        for(const auto& idx : m_positioned)
-        {
-            z_indexes[idx->src_el()->css().get_z_index()];
-        }
-
-        for(const auto& idx : z_indexes)
+        for(auto iter = z_indexes.begin(); iter != z_zero; ++iter)
         {
-            if(idx.first < 0)
-            {
-                draw_children(hdc, x, y, clip, draw_positioned, idx.first);
-            }
+            draw_children(hdc, x, y, clip, draw_positioned, *iter);
         }
     }
     draw_children(hdc, x, y, clip, draw_block, 0);
@@ -790,26 +811,21 @@ void litehtml::render_item::draw_stacking_context( uint_ptr hdc, pixel_t x, pixe
     draw_children(hdc, x, y, clip, draw_inlines, 0);
     if(with_positioned)
     {
-        for(auto& z_index : z_indexes)
+        for(auto iter = z_zero; iter != z_indexes.end(); ++iter)
         {
-            if(z_index.first == 0)
-            {
-                draw_children(hdc, x, y, clip, draw_positioned, z_index.first);
-            }
-        }
-
-        for(auto& z_index : z_indexes)
-        {
-            if(z_index.first > 0)
-            {
-                draw_children(hdc, x, y, clip, draw_positioned, z_index.first);
-            }
+            draw_children(hdc, x, y, clip, draw_positioned, *iter);
         }
     }
 }
 
 void litehtml::render_item::draw_children(uint_ptr hdc, pixel_t x, pixel_t y, const position* clip, draw_flag flag, int zindex)
 {
+    const paint_order::vector* items = m_paint_order.get(flag, zindex);
+    if(!items)
+    {
+        return;
+    }
+
     position pos = m_pos;
     pos.x += x - get_scroll_left();
     pos.y += y - get_scroll_top();
@@ -838,78 +854,45 @@ void litehtml::render_item::draw_children(uint_ptr hdc, pixel_t x, pixel_t y, co
         }
     }
 
-    for (const auto& el : m_children)
+    for (const auto& item : *items)
     {
-        if (el->is_visible())
+        const auto& el = item.el;
+        if (!el->is_visible())
         {
-            bool process = true;
-            switch (flag)
-            {
-                case draw_positioned:
-                    if (el->src_el()->is_positioned() && el->src_el()->css().get_z_index() == zindex)
-                    {
-                        if (el->src_el()->css().get_position() == element_position_fixed)
-						{
-							// Fixed elements position is always relative to the (0,0)
-                            el->src_el()->draw(hdc, 0, 0, clip, el);
-                            el->draw_stacking_context(hdc, 0, 0, clip, true);
-                        }
-                        else
-                        {
-                            el->src_el()->draw(hdc, pos.x, pos.y, clip, el);
-                            el->draw_stacking_context(hdc, pos.x, pos.y, clip, true);
-                        }
-                        process = false;
-                    }
-                    break;
-                case draw_block:
-                    if (!el->src_el()->is_inline() && el->src_el()->css().get_float() == float_none && !el->src_el()->is_positioned())
-                    {
-                        el->src_el()->draw(hdc, pos.x, pos.y, clip, el);
-                    }
-                    break;
-                case draw_floats:
-                    if (el->src_el()->css().get_float() != float_none && !el->src_el()->is_positioned())
-                    {
-                        el->src_el()->draw(hdc, pos.x, pos.y, clip, el);
-                        el->draw_stacking_context(hdc, pos.x, pos.y, clip, false);
-                        process = false;
-                    }
-                    break;
-                case draw_inlines:
-                    if (el->src_el()->is_inline() && el->src_el()->css().get_float() == float_none && !el->src_el()->is_positioned())
-                    {
-                        el->src_el()->draw(hdc, pos.x, pos.y, clip, el);
-                        if (el->src_el()->css().get_display() == display_inline_block || el->src_el()->css().get_display() == display_inline_flex)
-                        {
-                            el->draw_stacking_context(hdc, pos.x, pos.y, clip, false);
-                            process = false;
-                        }
-                    }
-                    break;
-                default:
-                    break;
-            }
-
-            if (process)
-            {
-                if (flag == draw_positioned)
-                {
-                    if (!el->src_el()->is_positioned())
-                    {
-                        el->draw_children(hdc, pos.x, pos.y, clip, flag, zindex);
-                    }
-                }
-                else
-                {
-                    if (el->src_el()->css().get_float() == float_none &&
-                        el->src_el()->css().get_display() != display_inline_block &&
-                        !el->src_el()->is_positioned())
-                    {
-                        el->draw_children(hdc, pos.x, pos.y, clip, flag, zindex);
-                    }
-                }
-            }
+            continue;
+        }
+        if (item.draw && flag == draw_positioned && el->src_el()->css().get_position() == element_position_fixed)
+        {
+            // Fixed elements position is always relative to the (0,0)
+            doc->begin_fixed_draw();
+            doc->begin_draw_group();
+            el->src_el()->draw(hdc, 0, 0, clip, el);
+            el->draw_stacking_context(hdc, 0, 0, clip, true);
+            doc->end_draw_group();
+            doc->end_fixed_draw();
+            continue;
+        }
+        // Leaf elements are culled by their own drawing operations
+        bool group = item.stacking || item.children;
+        if (group)
+        {
+            doc->begin_draw_group();
+        }
+        if (item.draw)
+        {
+            el->src_el()->draw(hdc, pos.x, pos.y, clip, el);
+        }
+        if (item.stacking)
+        {
+            el->draw_stacking_context(hdc, pos.x, pos.y, clip, flag == draw_positioned);
+        }
+        if (item.children)
+        {
+            el->draw_children(hdc, pos.x, pos.y, clip, flag, zindex);
+        }
+        if (group)
+        {
+            doc->end_draw_group();
         }
     }
 
@@ -935,11 +918,9 @@ std::shared_ptr<litehtml::element>  litehtml::render_item::get_child_by_point(pi
     el_pos.x	= x - el_pos.x + get_scroll_left();
     el_pos.y	= y - el_pos.y + get_scroll_top();
 
-    for(auto i = m_children.crbegin(); i != m_children.crend() && !ret; std::advance(i, 1))
+    auto process_child = [&](const std::shared_ptr<render_item>& el)
     {
-        const auto& el = *i;
-
-        if(el->is_visible() && el->src_el()->css().get_display() != display_inline_text)
+        if(el->is_visible() && el->src_el()->css().get_display() != display_inline_text && el->may_contain_point(el_pos.x, el_pos.y))
         {
         	bool process = true;
             switch(flag)
@@ -1070,6 +1051,34 @@ std::shared_ptr<litehtml::element>  litehtml::render_item::get_child_by_point(pi
                 }
             }
         }
+    };
+
+    if(flag == draw_positioned)
+    {
+        // Only the children leading to the elements with this z-index
+        const paint_order::vector* items = m_paint_order.get(flag, zindex);
+        if(items)
+        {
+            for(auto i = items->crbegin(); i != items->crend() && !ret; std::advance(i, 1))
+            {
+                process_child(i->el);
+            }
+        }
+    } else if(!m_hit_index.children.empty())
+    {
+        // The children go from top to bottom: skip the children below the point and stop
+        // when all the rest are above it
+        int idx = (int) (std::upper_bound(m_hit_index.tops.begin(), m_hit_index.tops.end(), el_pos.y) - m_hit_index.tops.begin()) - 1;
+        for(; idx >= 0 && !ret && m_hit_index.max_bottom[idx] > el_pos.y; idx--)
+        {
+            process_child(m_hit_index.children[idx]);
+        }
+    } else
+    {
+        for(auto i = m_children.crbegin(); i != m_children.crend() && !ret; std::advance(i, 1))
+        {
+            process_child(*i);
+        }
     }
 
     return ret;
@@ -1081,29 +1090,21 @@ std::shared_ptr<litehtml::element> litehtml::render_item::get_element_by_point(p
 
     element::ptr ret;
 
-    std::map<int, bool> z_indexes;
-
-    for(const auto& i : m_positioned)
-    {
-        z_indexes[i->src_el()->css().get_z_index()];
-    }
+    const std::vector<int>* z_indexes = &m_paint_order.z_indexes;
 
-    for(auto iter = z_indexes.rbegin(); iter != z_indexes.rend(); ++iter)
+    for(auto iter = z_indexes->rbegin(); iter != z_indexes->rend(); ++iter)
     {
-        if(iter->first > 0)
+        if(*iter > 0)
         {
-            ret = get_child_by_point(x, y, client_x, client_y, draw_positioned, iter->first, check);
+            ret = get_child_by_point(x, y, client_x, client_y, draw_positioned, *iter, check);
 			if(ret) return ret;
         }
     }
 
-    for(const auto& z_index : z_indexes)
+    if(std::binary_search(z_indexes->begin(), z_indexes->end(), 0))
     {
-        if(z_index.first == 0)
-        {
-            ret = get_child_by_point(x, y, client_x, client_y, draw_positioned, z_index.first, check);
-			if(ret) return ret;
-        }
+        ret = get_child_by_point(x, y, client_x, client_y, draw_positioned, 0, check);
+        if(ret) return ret;
     }
 
     ret = get_child_by_point(x, y, client_x, client_y, draw_inlines, 0, check);
@@ -1116,11 +1117,11 @@ std::shared_ptr<litehtml::element> litehtml::render_item::get_element_by_point(p
     if(ret) return ret;
 
 
-	for(auto iter = z_indexes.rbegin(); iter != z_indexes.rend(); ++iter)
+	for(auto iter = z_indexes->rbegin(); iter != z_indexes->rend(); ++iter)
 	{
-        if(iter->first < 0)
+        if(*iter < 0)
         {
-            ret = get_child_by_point(x, y, client_x, client_y, draw_positioned, iter->first, check);
+            ret = get_child_by_point(x, y, client_x, client_y, draw_positioned, *iter, check);
 			if(ret) return ret;
         }
     }
@@ -1149,6 +1150,215 @@ std::shared_ptr<litehtml::element> litehtml::render_item::get_element_by_point(p
     return ret;
 }
 
+void litehtml::render_item::update_hit_index()
+{
+	// Children with more items use the top to bottom order to skip the children below the point
+	const size_t min_sorted_children = 16;
+
+	m_hit_index.children.clear();
+	m_hit_index.tops.clear();
+	m_hit_index.max_bottom.clear();
+
+	bool has_bounds = false;
+	position bounds;
+	auto add_box = [&has_bounds, &bounds](const position& box)
+		{
+			if(!has_bounds)
+			{
+				bounds = box;
+				has_bounds = true;
+			} else
+			{
+				pixel_t left	= std::min(bounds.left(), box.left());
+				pixel_t top		= std::min(bounds.top(), box.top());
+				pixel_t right	= std::max(bounds.right(), box.right());
+				pixel_t bottom	= std::max(bounds.bottom(), box.bottom());
+				bounds = position(left, top, right - left, bottom - top);
+			}
+		};
+
+	// The own hit area, see is_point_inside()
+	if(src_el()->css().get_display() != display_inline && src_el()->css().get_display() != display_table_row)
+	{
+		position pos = m_pos;
+		pos += m_padding;
+		pos += m_borders;
+		add_box(pos);
+	} else
+	{
+		position::vector boxes;
+		get_inline_boxes(boxes);
+		for(const auto& box : boxes)
+		{
+			add_box(box);
+		}
+	}
+
+	bool unbounded = src_el()->css().get_position() == element_position_fixed;
+	bool sorted = m_children.size() >= min_sorted_children;
+	bool clip_children = src_el()->css().get_overflow() > overflow_visible;
+	if(clip_children)
+	{
+		// Children are hit inside the content box only
+		add_box(m_pos);
+	}
+
+	for(const auto& el : m_children)
+	{
+		el->update_hit_index();
+		if(el->src_el()->css().get_display() == display_none || el->layout_pending())
+		{
+			continue;
+		}
+		if(el->m_hit_index.unbounded)
+		{
+			unbounded = true;
+			sorted = false;
+			continue;
+		}
+		const position& box = el->m_hit_index.bounds;
+		if(sorted)
+		{
+			if(!m_hit_index.tops.empty() && box.top() < m_hit_index.tops.back())
+			{
+				sorted = false;
+			} else
+			{
+				m_hit_index.children.push_back(el);
+				m_hit_index.tops.push_back(box.top());
+				m_hit_index.max_bottom.push_back(m_hit_index.max_bottom.empty() ? box.bottom() : std::max(m_hit_index.max_bottom.back(), box.bottom()));
+			}
+		}
+		if(!clip_children)
+		{
+			// Only the clipped elements can scroll, so the bounds don't depend on the scroll position
+			position child_box = box;
+			child_box.x += m_pos.x;
+			child_box.y += m_pos.y;
+			add_box(child_box);
+		}
+	}
+
+	if(!sorted)
+	{
+		m_hit_index.children.clear();
+		m_hit_index.tops.clear();
+		m_hit_index.max_bottom.clear();
+	}
+	m_hit_index.bounds = bounds;
+	m_hit_index.unbounded = unbounded || !has_bounds;
+}
+
+void litehtml::render_item::update_paint_order()
+{
+	m_paint_order.z_indexes.clear();
+	m_paint_order.blocks.clear();
+	m_paint_order.floats.clear();
+	m_paint_order.inlines.clear();
+	m_paint_order.positioned.clear();
+
+	for(const auto& el : m_positioned)
+	{
+		m_paint_order.z_indexes.push_back(el->src_el()->css().get_z_index());
+	}
+	std::sort(m_paint_order.z_indexes.begin(), m_paint_order.z_indexes.end());
+	m_paint_order.z_indexes.erase(std::unique(m_paint_order.z_indexes.begin(), m_paint_order.z_indexes.end()), m_paint_order.z_indexes.end());
+
+	auto add_positioned = [this](int zindex, const paint_order::item& item)
+		{
+			auto& positioned = m_paint_order.positioned;
+			auto iter = std::lower_bound(positioned.begin(), positioned.end(), zindex,
+										 [](const std::pair<int, paint_order::vector>& z, int val) { return z.first < val; });
+			if(iter == positioned.end() || iter->first != zindex)
+			{
+				iter = positioned.insert(iter, {zindex, {}});
+			}
+			iter->second.push_back(item);
+		};
+
+	for(const auto& el : m_children)
+	{
+		el->update_paint_order();
+
+		const auto& el_css = el->src_el()->css();
+		bool is_positioned	= el->src_el()->is_positioned();
+		bool is_inline		= el->src_el()->is_inline();
+		bool is_floated		= el_css.get_float() != float_none;
+		// Children of the floats, inline-blocks and positioned elements are drawn in their own passes
+		bool draw_children	= !is_floated && el_css.get_display() != display_inline_block && !is_positioned;
+
+		if(is_positioned)
+		{
+			add_positioned(el_css.get_z_index(), {el, true, true, false});
+			continue;
+		}
+		for(const auto& z : el->m_paint_order.positioned)
+		{
+			add_positioned(z.first, {el, false, false, true});
+		}
+
+		if(is_floated)
+		{
+			m_paint_order.floats.push_back({el, true, true, false});
+		} else
+		{
+			if(!is_inline)
+			{
+				m_paint_order.blocks.push_back({el, true, false, draw_children && !el->m_paint_order.blocks.empty()});
+			} else
+			{
+				bool stacking = el_css.get_display() == display_inline_block || el_css.get_display() == display_inline_flex;
+				m_paint_order.inlines.push_back({el, true, stacking, !stacking && draw_children && !el->m_paint_order.inlines.empty()});
+			}
+			if(draw_children && !el->m_paint_order.floats.empty())
+			{
+				m_paint_order.floats.push_back({el, false, false, true});
+			}
+		}
+		if(draw_children)
+		{
+			if(is_inline && !el->m_paint_order.blocks.empty())
+			{
+				m_paint_order.blocks.push_back({el, false, false, true});
+			}
+			if(!is_inline && !el->m_paint_order.inlines.empty())
+			{
+				m_paint_order.inlines.push_back({el, false, false, true});
+			}
+		}
+	}
+}
+
+const litehtml::render_item::paint_order::vector* litehtml::render_item::paint_order::get(draw_flag flag, int zindex) const
+{
+	const vector* ret = nullptr;
+	switch(flag)
+	{
+		case draw_block:
+			ret = &blocks;
+			break;
+		case draw_floats:
+			ret = &floats;
+			break;
+		case draw_inlines:
+			ret = &inlines;
+			break;
+		case draw_positioned:
+			{
+				auto iter = std::lower_bound(positioned.begin(), positioned.end(), zindex,
+											 [](const std::pair<int, vector>& z, int val) { return z.first < val; });
+				if(iter != positioned.end() && iter->first == zindex)
+				{
+					ret = &iter->second;
+				}
+			}
+			break;
+		default:
+			break;
+	}
+	return ret && !ret->empty() ? ret : nullptr;
+}
+
 bool litehtml::render_item::is_point_inside( pixel_t x, pixel_t y ) const
 {
 	if(src_el()->css().get_display() != display_inline && src_el()->css().get_display() != display_table_row)
@@ -1254,6 +1464,32 @@ void litehtml::render_item::dump(litehtml::dumper& cout)
     cout.end_node();
 }
 
+void litehtml::render_item::add_memory_usage(document_memory_usage& usage) const
+{
+	size_t paint_order_bytes = heap_size(m_paint_order.z_indexes) +
+							   (m_paint_order.blocks.capacity() + m_paint_order.floats.capacity() + m_paint_order.inlines.capacity()) * sizeof(paint_order::item) +
+							   m_paint_order.positioned.capacity() * sizeof(std::pair<int, paint_order::vector>);
+	for(const auto& layer : m_paint_order.positioned)
+	{
+		paint_order_bytes += layer.second.capacity() * sizeof(paint_order::item);
+	}
+
+	usage.render_items++;
+	usage.render_item_bytes += sizeof(render_item) + shared_count_size +
+							   heap_size(m_children) +
+							   heap_size(m_positioned) +
+							   heap_size(m_hit_index.children) + heap_size(m_hit_index.tops) + heap_size(m_hit_index.max_bottom) +
+							   paint_order_bytes +
+							   m_gradients_cache.linear.capacity() * sizeof(m_gradients_cache.linear[0]) +
+							   m_gradients_cache.radial.capacity() * sizeof(m_gradients_cache.radial[0]) +
+							   m_gradients_cache.conic.capacity() * sizeof(m_gradients_cache.conic[0]);
+
+	for(const auto& el : m_children)
+	{
+		el->add_memory_usage(usage);
+	}
+}
+
 litehtml::position litehtml::render_item::get_placement() const
 {
 	litehtml::position pos = m_pos;
@@ -1,6 +1,7 @@
 #include "render_table.h"
 #include "document.h"
 #include "iterators.h"
+#include "thread_pool.h"
 
 
 litehtml::render_item_table::render_item_table(std::shared_ptr<element> _src_el) :
@@ -14,6 +15,7 @@ litehtml::rendered_width litehtml::render_item_table::_render(pixel_t x, pixel_t
 															  const containing_block_context& containing_block_size,
 															  formatting_context* fmt_ctx, bool /*second_pass*/)
 {
+	LH_TRACE_SCOPE(src_el()->get_document()->get_trace_sink(), "render_item_table::_render", src_el().get());
 	if(!m_grid)
 		return {0, 0};
 
@@ -42,6 +44,14 @@ litehtml::rendered_width litehtml::render_item_table::_render(pixel_t x, pixel_t
     }
 
 
+    if (m_grid->fixed_layout())
+    {
+        // The fixed table layout doesn't depend on the cells content, so each cell is rendered only once
+        // with the final width.
+        pixel_t table_width = m_grid->calc_fixed_table_width(self_size.render_width - table_width_spacing) + table_width_spacing;
+        return render_cells(x, y, containing_block_size, self_size, fmt_ctx, table_width, table_width);
+    }
+
     // Calculate the minimum content width (MCW) of each cell: the formatted content may span any number of lines but may not overflow the cell box.
     // If the specified 'width' (W) of the cell is greater than MCW, W is the minimum cell width. A value of 'auto' means that MCW is the minimum
     // cell width.
@@ -50,103 +60,42 @@ litehtml::rendered_width litehtml::render_item_table::_render(pixel_t x, pixel_t
 
     if (m_grid->cols_count() == 1 && self_size.width.type != containing_block_context::cbc_value_type_auto)
     {
-        for (int row = 0; row < m_grid->rows_count(); row++)
-        {
-            table_cell* cell = m_grid->cell(0, row);
-            if (cell && cell->el)
-            {
+		for_each_cell([&](int /*col*/, int /*row*/, table_cell* cell)
+			{
 				auto rw =
 					cell->el->render(0, 0, self_size.new_width(self_size.render_width - table_width_spacing), fmt_ctx);
 				cell->min_width = rw.min_width;
 				cell->max_width = rw.natural_width;
-			}
-		}
+			});
 	} else
 	{
-		for(int row = 0; row < m_grid->rows_count(); row++)
-		{
-			for(int col = 0; col < m_grid->cols_count(); col++)
+		for_each_cell([&](int col, int /*row*/, table_cell* cell)
 			{
-				table_cell* cell = m_grid->cell(col, row);
-				if(cell && cell->el)
+				if(!m_grid->column(col).css_width.is_predefined() &&
+				   m_grid->column(col).css_width.units() != css_units_percentage)
 				{
-					if(!m_grid->column(col).css_width.is_predefined() &&
-					   m_grid->column(col).css_width.units() != css_units_percentage)
-					{
-						pixel_t css_w = m_grid->column(col).css_width.calc_percent(self_size.width);
-						pixel_t el_w	= cell->el->render(0, 0, self_size.new_width(css_w), fmt_ctx).natural_width;
-						cell->min_width = cell->max_width = std::max(css_w, el_w);
-						cell->el->pos().width =
-							cell->min_width - cell->el->content_offset_left() - cell->el->content_offset_right();
-					} else
-					{
-						// calculate minimum content width
-						cell->min_width =
-							cell->el->render(0, 0, self_size.new_width(cell->el->content_offset_width()), fmt_ctx)
-								.natural_width;
-						// calculate maximum content width
-						cell->max_width =
-							cell->el
-								->render(0, 0, self_size.new_width(self_size.render_width - table_width_spacing),
-										 fmt_ctx)
-								.natural_width;
-					}
+					pixel_t css_w = m_grid->column(col).css_width.calc_percent(self_size.width);
+					pixel_t el_w	= cell->el->render(0, 0, self_size.new_width(css_w), fmt_ctx).natural_width;
+					cell->min_width = cell->max_width = std::max(css_w, el_w);
+					cell->el->pos().width =
+						cell->min_width - cell->el->content_offset_left() - cell->el->content_offset_right();
+				} else
+				{
+					// calculate minimum content width
+					cell->min_width =
+						cell->el->render(0, 0, self_size.new_width(cell->el->content_offset_width()), fmt_ctx)
+							.natural_width;
+					// calculate maximum content width
+					cell->max_width =
+						cell->el
+							->render(0, 0, self_size.new_width(self_size.render_width - table_width_spacing),
+									 fmt_ctx)
+							.natural_width;
 				}
-			}
-		}
+			});
 	}
 
-	// For each column, determine a maximum and minimum column width from the cells that span only that column.
-	// The minimum is that required by the cell with the largest minimum cell width (or the column 'width', whichever is
-	// larger).
-	// The maximum is that required by the cell with the largest maximum cell width (or the column 'width', whichever is
-	// larger).
-
-	for(int col = 0; col < m_grid->cols_count(); col++)
-	{
-		m_grid->column(col).max_width = 0;
-		m_grid->column(col).min_width = 0;
-		for(int row = 0; row < m_grid->rows_count(); row++)
-		{
-			if(m_grid->cell(col, row)->colspan <= 1)
-			{
-				m_grid->column(col).max_width =
-					std::max(m_grid->column(col).max_width, m_grid->cell(col, row)->max_width);
-				m_grid->column(col).min_width =
-					std::max(m_grid->column(col).min_width, m_grid->cell(col, row)->min_width);
-			}
-		}
-	}
-
-	// For each cell that spans more than one column, increase the minimum widths of the columns it spans so that
-	// together,
-	// they are at least as wide as the cell. Do the same for the maximum widths.
-	// If possible, widen all spanned columns by approximately the same amount.
-
-	for(int col = 0; col < m_grid->cols_count(); col++)
-	{
-		for(int row = 0; row < m_grid->rows_count(); row++)
-		{
-			if(m_grid->cell(col, row)->colspan > 1)
-            {
-                pixel_t max_total_width = m_grid->column(col).max_width;
-                pixel_t min_total_width = m_grid->column(col).min_width;
-                for (int col2 = col + 1; col2 < col + m_grid->cell(col, row)->colspan; col2++)
-                {
-                    max_total_width += m_grid->column(col2).max_width;
-                    min_total_width += m_grid->column(col2).min_width;
-                }
-                if (min_total_width < m_grid->cell(col, row)->min_width)
-                {
-                    m_grid->distribute_min_width(m_grid->cell(col, row)->min_width - min_total_width, col, col + m_grid->cell(col, row)->colspan - 1);
-                }
-                if (max_total_width < m_grid->cell(col, row)->max_width)
-                {
-                    m_grid->distribute_max_width(m_grid->cell(col, row)->max_width - max_total_width, col, col + m_grid->cell(col, row)->colspan - 1);
-                }
-            }
-        }
-    }
+	m_grid->calc_columns_min_max();
 
     // If the 'table' or 'inline-table' element's 'width' property has a computed value (W) other than 'auto', the used width is the
     // greater of W, CAPMIN, and the minimum width required by all the columns plus cell spacing or borders (MIN).
@@ -173,11 +122,37 @@ litehtml::rendered_width litehtml::render_item_table::_render(pixel_t x, pixel_t
     min_table_width += table_width_spacing;
     max_table_width += table_width_spacing;
     table_width += table_width_spacing;
+
+    return render_cells(x, y, containing_block_size, self_size, fmt_ctx, table_width, max_table_width);
+}
+
+// Renders the cells with the computed table width, the widths include the table spacing
+litehtml::rendered_width litehtml::render_item_table::render_cells(pixel_t x, pixel_t y,
+																   const containing_block_context& containing_block_size,
+																   const containing_block_context& self_size,
+																   formatting_context* fmt_ctx, pixel_t table_width,
+																   pixel_t max_table_width)
+{
     m_grid->calc_horizontal_positions(m_borders, src_el()->css().get_border_collapse(), m_border_spacing_x);
 
     bool row_span_found = false;
 
     // render cells with computed width
+    for_each_cell([&](int col, int /*row*/, table_cell* cell)
+        {
+            int span_col = col + cell->colspan - 1;
+            if (span_col >= m_grid->cols_count())
+            {
+                span_col = m_grid->cols_count() - 1;
+            }
+            pixel_t cell_width = m_grid->column(span_col).right - m_grid->column(col).left;
+
+            cell->el->render(m_grid->column(col).left, 0, self_size.new_width(cell_width), fmt_ctx, true);
+            cell->el->pos().width = cell_width - cell->el->content_offset_left() -
+                    cell->el->content_offset_right();
+        });
+
+    // merge the cells heights into the rows
     for (int row = 0; row < m_grid->rows_count(); row++)
     {
         m_grid->row(row).height = 0;
@@ -186,25 +161,6 @@ litehtml::rendered_width litehtml::render_item_table::_render(pixel_t x, pixel_t
             table_cell* cell = m_grid->cell(col, row);
             if (cell->el)
             {
-                int span_col = col + cell->colspan - 1;
-                if (span_col >= m_grid->cols_count())
-                {
-                    span_col = m_grid->cols_count() - 1;
-                }
-                pixel_t cell_width = m_grid->column(span_col).right - m_grid->column(col).left;
-
-                //if (cell->el->pos().width != cell_width - cell->el->content_offset_left() -
-				//									 cell->el->content_offset_right())
-                {
-                    cell->el->render(m_grid->column(col).left, 0, self_size.new_width(cell_width), fmt_ctx, true);
-                    cell->el->pos().width = cell_width - cell->el->content_offset_left() -
-							cell->el->content_offset_right();
-                }
-                /*else
-                {
-                    cell->el->pos().x = m_grid->column(col).left + cell->el->content_offset_left();
-                }*/
-
                 if (cell->rowspan <= 1)
                 {
                     m_grid->row(row).height = std::max(m_grid->row(row).height, cell->el->height());
@@ -392,6 +348,43 @@ litehtml::rendered_width litehtml::render_item_table::_render(pixel_t x, pixel_t
 	return {table_width + content_offset_width(), table_width + content_offset_width()};
 }
 
+void litehtml::render_item_table::for_each_cell(const std::function<void(int col, int row, table_cell* cell)>& func)
+{
+	thread_pool* pool = src_el()->get_document()->layout_pool();
+	if(!pool)
+	{
+		for(int row = 0; row < m_grid->rows_count(); row++)
+		{
+			for(int col = 0; col < m_grid->cols_count(); col++)
+			{
+				table_cell* cell = m_grid->cell(col, row);
+				if(cell && cell->el)
+				{
+					func(col, row, cell);
+				}
+			}
+		}
+		return;
+	}
+
+	std::vector<std::pair<int, int>> cells;
+	for(int row = 0; row < m_grid->rows_count(); row++)
+	{
+		for(int col = 0; col < m_grid->cols_count(); col++)
+		{
+			table_cell* cell = m_grid->cell(col, row);
+			if(cell && cell->el)
+			{
+				cells.emplace_back(col, row);
+			}
+		}
+	}
+	pool->parallel_for(cells.size(), [&](size_t i)
+		{
+			func(cells[i].first, cells[i].second, m_grid->cell(cells[i].first, cells[i].second));
+		});
+}
+
 std::shared_ptr<litehtml::render_item> litehtml::render_item_table::init()
 {
     // Initialize Grid
@@ -419,16 +412,43 @@ std::shared_ptr<litehtml::render_item> litehtml::render_item_table::init()
                 });
         });
 
+    auto get_span = [](const std::shared_ptr<render_item>& el)
+        {
+            // https://html.spec.whatwg.org/multipage/tables.html#attr-col-span
+            return std::min(std::max(atoi(el->src_el()->get_attr("span", "1")), 1), 1000);
+        };
+
     for (auto& el : m_children)
     {
         if (el->src_el()->css().get_display() == display_table_caption)
         {
             el = el->init();
             m_grid->captions().push_back(el);
+        } else if (el->src_el()->css().get_display() == display_table_column)
+        {
+            m_grid->add_column(el->src_el()->css().get_width(), get_span(el));
+        } else if (el->src_el()->css().get_display() == display_table_column_group)
+        {
+            bool has_columns = false;
+            for (const auto& col : el->children())
+            {
+                if (col->src_el()->css().get_display() == display_table_column)
+                {
+                    has_columns = true;
+                    const css_length& width = col->src_el()->css().get_width().is_predefined() ?
+                        el->src_el()->css().get_width() : col->src_el()->css().get_width();
+                    m_grid->add_column(width, get_span(col));
+                }
+            }
+            if (!has_columns)
+            {
+                m_grid->add_column(el->src_el()->css().get_width(), get_span(el));
+            }
         }
     }
 
-    m_grid->finish();
+    // The fixed table layout is used only if the table width is not auto
+    m_grid->finish(src_el()->css().get_table_layout() == table_layout_fixed && !src_el()->css().get_width().is_predefined());
 
 	if(src_el()->css().get_border_collapse() == border_collapse_separate)
 	{
@@ -492,6 +512,16 @@ litehtml::pixel_t litehtml::render_item_table::get_draw_vertical_offset()
     return 0;
 }
 
+void litehtml::render_item_table::add_memory_usage(document_memory_usage& usage) const
+{
+	render_item::add_memory_usage(usage);
+	usage.render_item_bytes += sizeof(render_item_table) - sizeof(render_item);
+	if(m_grid)
+	{
+		usage.render_item_bytes += sizeof(table_grid) + m_grid->memory_usage();
+	}
+}
+
 void litehtml::render_item_table_row::get_inline_boxes( position::vector& boxes ) const
 {
 	position pos;
@@ -0,0 +1,108 @@
+#include "rule_tree.h"
+#include "memory_usage.h"
+
+litehtml::rule_node* litehtml::rule_node::add(const style* rule)
+{
+	auto& child = m_children[rule];
+	if(!child)
+	{
+		child = std::make_unique<rule_node>(this, rule);
+	}
+	return child.get();
+}
+
+litehtml::rule_node* litehtml::rule_node::add_own(style&& rule)
+{
+	auto own_rule = std::make_unique<style>(std::move(rule));
+	auto child = std::make_unique<rule_node>(this, own_rule.get());
+	child->m_own_rule = std::move(own_rule);
+	m_own_children.push_back(std::move(child));
+	return m_own_children.back().get();
+}
+
+const litehtml::style& litehtml::rule_node::cascaded() const
+{
+	if(!m_cascaded)
+	{
+		// start from the nearest node with the cascaded style and apply the rest of the rules
+		std::vector<const style*> rules;
+		const rule_node* node = this;
+		for(; node && !node->m_cascaded; node = node->m_parent)
+		{
+			if(node->m_rule)
+			{
+				rules.push_back(node->m_rule);
+			}
+		}
+		m_cascaded = node ? std::make_unique<style>(*node->m_cascaded) : std::make_unique<style>();
+		for(auto it = rules.rbegin(); it != rules.rend(); ++it)
+		{
+			m_cascaded->combine(**it);
+		}
+		m_has_vars = m_cascaded->has_vars();
+	}
+	return *m_cascaded;
+}
+
+bool litehtml::rule_node::has_vars() const
+{
+	cascaded();
+	return m_has_vars;
+}
+
+// The last important value wins, otherwise the last value, see style::add_parsed_property()
+const litehtml::property_value& litehtml::rule_node::get_property(string_id name) const
+{
+	static const property_value invalid_value;
+	const property_value* last = nullptr;
+	for(const rule_node* node = this; node; node = node->m_parent)
+	{
+		if(node->m_cascaded)
+		{
+			const property_value& val = node->m_cascaded->get_property(name);
+			return (val.m_important || !last) ? val : *last;
+		}
+		if(node->m_rule)
+		{
+			const property_value& val = node->m_rule->get_property(name);
+			if(val.is<invalid>())
+			{
+				continue;
+			}
+			if(val.m_important)
+			{
+				return val;
+			}
+			if(!last)
+			{
+				last = &val;
+			}
+		}
+	}
+	return last ? *last : invalid_value;
+}
+
+void litehtml::rule_node::add_memory_usage(document_memory_usage& usage) const
+{
+	usage.rule_nodes++;
+	usage.rule_tree_bytes += m_children.size() * (tree_node_overhead + sizeof(children_map::value_type)) +
+							 m_own_children.capacity() * sizeof(std::unique_ptr<rule_node>);
+	if(m_own_rule)
+	{
+		usage.rule_tree_bytes += sizeof(style) + m_own_rule->memory_usage();
+	}
+	if(m_cascaded)
+	{
+		usage.rule_tree_bytes += sizeof(style) + m_cascaded->memory_usage();
+	}
+	for(const auto& child : m_children)
+	{
+		usage.rule_tree_bytes += sizeof(rule_node);
+		child.second->add_memory_usage(usage);
+	}
+	for(const auto& child : m_own_children)
+	{
+		usage.rule_tree_bytes += sizeof(rule_node);
+		child->add_memory_usage(usage);
+	}
+}
@@ -1,9 +1,12 @@
 #include "html.h"
 #include "string_id.h"
+#include "memory_usage.h"
 #include <cassert>
 
 #ifndef LITEHTML_NO_THREADS
+	#include <atomic>
 	#include <mutex>
+	#include <unordered_map>
 	static std::mutex mutex;
 	#define lock_guard std::lock_guard<std::mutex> lock(mutex)
 #else
@@ -13,8 +16,45 @@
 namespace litehtml
 {
 
+// The strings are stored in chunks that are never moved, chunk k holds the ids from first_id(k) to first_id(k+1)-1.
+// So _s() reads the string without locking: the string is stored before its id is returned by _id().
+const int first_chunk_size = 1024;
+const int max_chunks = 32;
+
 static std::map<string, string_id> map;
-static std::vector<string> array;
+#ifndef LITEHTML_NO_THREADS
+static std::atomic<string*> chunks[max_chunks];
+#else
+static string* chunks[max_chunks];
+#endif
+static int count = 0;
+
+static int first_id(int chunk)
+{
+	return first_chunk_size * ((1 << chunk) - 1);
+}
+
+static int chunk_of(int id)
+{
+	int chunk = 0;
+	for (unsigned n = (unsigned) (id / first_chunk_size + 1); n > 1; n >>= 1)
+		chunk++;
+	return chunk;
+}
+
+// Adds the string, must be called under the lock
+static string_id add(const string& str)
+{
+	int chunk = chunk_of(count);
+	string* strings = chunks[chunk];
+	if (!strings)
+	{
+		strings = new string[first_id(chunk + 1) - first_id(chunk)];
+		chunks[chunk] = strings;
+	}
+	strings[count - first_id(chunk)] = str;
+	return map[str] = (string_id)count++;
+}
 
 static int init()
 {
@@ -37,18 +77,45 @@ const string_id star_id = _id("*");
 
 string_id _id(const string& str)
 {
-	lock_guard;
-	auto it = map.find(str);
-	if (it != map.end()) return it->second;
-	// else: str not found, add it to the array and the map
-	array.push_back(str);
-	return map[str] = (string_id)(array.size() - 1);
+#ifndef LITEHTML_NO_THREADS
+	// every thread looks up the known strings in its own cache, so parsing doesn't contend for the lock
+	thread_local std::unordered_map<string, string_id> cache;
+	auto cached = cache.find(str);
+	if (cached != cache.end()) return cached->second;
+#endif
+	string_id id;
+	{
+		lock_guard;
+		auto it = map.find(str);
+		// if str is not found, add it to the chunks and the map
+		id = it != map.end() ? it->second : add(str);
+	}
+#ifndef LITEHTML_NO_THREADS
+	cache.emplace(str, id);
+#endif
+	return id;
 }
 
 const string& _s(string_id id)
+{
+	int chunk = chunk_of(id);
+	return chunks[chunk][id - first_id(chunk)];
+}
+
+void string_ids_memory_usage(size_t& ids_count, size_t& bytes)
 {
 	lock_guard;
-	return array[id];
+	ids_count = (size_t) count;
+	bytes = map.size() * (tree_node_overhead + sizeof(std::map<string, string_id>::value_type));
+	for (int chunk = 0; chunk < max_chunks && chunks[chunk]; chunk++)
+	{
+		bytes += (size_t) (first_id(chunk + 1) - first_id(chunk)) * sizeof(string);
+	}
+	for (const auto& item : map)
+	{
+		// the string is stored in the map and in the chunk
+		bytes += heap_size(item.first) * 2;
+	}
 }
 
 } // namespace litehtml
\ No newline at end of file
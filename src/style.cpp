@@ -23,7 +23,7 @@ bool parse_border_width(const css_token& tok, css_length& width);
 bool parse_font_family(const css_token_vector& tokens, string& font_family);
 bool parse_font_weight(const css_token& tok, css_length& weight);
 
-std::map<string_id, string> style::m_valid_values =
+const std::map<string_id, string> style::m_valid_values =
 {
 	{ _display_, style_display_strings },
 	{ _visibility_, visibility_strings },
@@ -66,12 +66,13 @@ std::map<string_id, string> style::m_valid_values =
 	{ _align_self_, flex_align_items_strings },
 
 	{ _caption_side_, caption_side_strings },
+	{ _table_layout_, table_layout_strings },
 
 	{ _text_decoration_style_, style_text_decoration_style_strings },
 	{ _text_emphasis_position_, style_text_emphasis_position_strings },
 };
 
-std::map<string_id, vector<string_id>> shorthands =
+static const std::map<string_id, vector<string_id>> shorthands =
 {
 	{ _font_, {_font_style_, _font_variant_, _font_weight_, _font_size_, _line_height_, _font_family_}},
 
@@ -116,14 +117,14 @@ std::map<string_id, vector<string_id>> shorthands =
 void style::add(const string& txt, const string& baseurl, document_container* container)
 {
 	auto tokens = normalize(txt, f_componentize);
-	add(tokens, baseurl, container);
+	add(std::move(tokens), baseurl, container);
 }
 
-void style::add(const css_token_vector& tokens, const string& baseurl, document_container* container)
+void style::add(css_token_vector tokens, const string& baseurl, document_container* container)
 {
 	raw_declaration::vector decls;
 	raw_rule::vector rules;
-	css_parser(tokens).consume_style_block_contents(decls, rules);
+	css_parser(std::move(tokens)).consume_style_block_contents(decls, rules);
 	if (!rules.empty())
 		css_parse_error("rule inside a style block");
 	if (decls.empty())
@@ -182,7 +183,8 @@ void style::add_property(string_id name, const css_token_vector& value, const st
 		return add_parsed_property(name, property_value(value, important, true));
 
 	// valid only if value contains a single token
-	css_token val = value.size() == 1 ? value[0] : css_token();
+	static const css_token no_token;
+	const css_token& val = value.size() == 1 ? value[0] : no_token;
 	// nonempty if value is a single identifier
 	string ident = val.ident();
 
@@ -231,8 +233,9 @@ void style::add_property(string_id name, const css_token_vector& value, const st
 	case _align_content_:
 
 	case _caption_side_:
+	case _table_layout_:
 
-		if (int index = value_index(ident, m_valid_values[name]); index >= 0)
+		if (int index = value_index(ident, m_valid_values.at(name)); index >= 0)
 			add_parsed_property(name, property_value(index, important));
 		break;
 
@@ -1064,7 +1067,7 @@ void style::parse_keyword_comma_list(string_id name, const css_token_vector& tok
 	{
 		int idx;
 		if (layer.size() != 1) return;
-		if (!parse_keyword(layer[0], idx, m_valid_values[name])) return;
+		if (!parse_keyword(layer[0], idx, m_valid_values.at(name))) return;
 		vec.push_back(idx);
 	}
 
@@ -1545,19 +1548,19 @@ void style::parse_align_self(string_id name, const css_token_vector& tokens, boo
 	}
 }
 
-void style::add_parsed_property( string_id name, const property_value& propval )
+void style::add_parsed_property( string_id name, property_value propval )
 {
 	auto prop = m_properties.find(name);
 	if (prop != m_properties.end())
 	{
 		if (!prop->second.m_important || (propval.m_important && prop->second.m_important))
 		{
-			prop->second = propval;
+			prop->second = std::move(propval);
 		}
 	}
 	else
 	{
-		m_properties[name] = propval;
+		m_properties[name] = std::move(propval);
 	}
 }
 
@@ -1670,4 +1673,19 @@ void style::subst_vars(const html_tag* el)
 	}
 }
 
+bool style::has_vars() const
+{
+	for (const auto& prop : m_properties)
+	{
+		if (prop.second.m_has_var)
+			return true;
+	}
+	return false;
+}
+
+size_t style::memory_usage() const
+{
+	return heap_size(m_properties);
+}
+
 } // namespace litehtml
\ No newline at end of file
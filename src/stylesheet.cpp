@@ -118,7 +118,7 @@ bool css::parse_style_rule(raw_rule::ptr rule, string baseurl, document::ptr doc
 
 	style::ptr style = make_shared<litehtml::style>(); // style block
 	// The content of the qualified rule's block is parsed as a style block's contents.
-	style->add(rule->block.value, baseurl, doc->container());
+	style->add(std::move(rule->block.value), baseurl, doc->container());
 
 	for (auto sel : list)
 	{
@@ -11,6 +11,8 @@ void litehtml::table_grid::add_cell(const std::shared_ptr<render_item>& el)
 	cell.colspan	= atoi(el->src_el()->get_attr("colspan", "1"));
 	cell.rowspan	= atoi(el->src_el()->get_attr("rowspan", "1"));
 	cell.borders	= el->get_borders();
+	if(cell.colspan > 1) m_has_colspan = true;
+	if(cell.rowspan > 1) m_has_rowspan = true;
 
 	while( is_rowspanned( (int) m_cells.size() - 1, (int) m_cells.back().size() ) )
 	{
@@ -26,6 +28,15 @@ void litehtml::table_grid::add_cell(const std::shared_ptr<render_item>& el)
 }
 
 
+void litehtml::table_grid::add_column(const css_length& css_width, int span)
+{
+	for(int i = 0; i < span; i++)
+	{
+		m_columns_css_width.push_back(css_width);
+	}
+}
+
+
 void litehtml::table_grid::begin_row(const std::shared_ptr<render_item>& row)
 {
 	std::vector<table_cell> r;
@@ -37,6 +48,10 @@ void litehtml::table_grid::begin_row(const std::shared_ptr<render_item>& row)
 
 bool litehtml::table_grid::is_rowspanned( int r, int c )
 {
+	if(!m_has_rowspan)
+	{
+		return false;
+	}
 	for(int row = r - 1; row >= 0; row--)
 	{
 		if(c < (int) m_cells[row].size())
@@ -53,10 +68,11 @@ bool litehtml::table_grid::is_rowspanned( int r, int c )
 	return false;
 }
 
-void litehtml::table_grid::finish()
+void litehtml::table_grid::finish(bool fixed_layout)
 {
+	m_fixed_layout	= fixed_layout;
 	m_rows_count	= (int) m_cells.size();
-	m_cols_count	= 0;
+	m_cols_count	= (int) m_columns_css_width.size();
 	for(auto& cell : m_cells)
 	{
 		m_cols_count = std::max(m_cols_count, (int) cell.size());
@@ -74,6 +90,10 @@ void litehtml::table_grid::finish()
 	for(int i = 0; i < m_cols_count; i++)
 	{
 		m_columns.emplace_back(0, 0);
+		if(i < (int) m_columns_css_width.size())
+		{
+			m_columns.back().css_width = m_columns_css_width[i];
+		}
 	}
 
 	for(int col = 0; col < m_cols_count; col++)
@@ -116,7 +136,8 @@ void litehtml::table_grid::finish()
 				}
 			}
 
-			if(cell(col, row)->el && cell(col, row)->colspan <= 1)
+			// the fixed table layout takes the columns width from the first row only
+			if(cell(col, row)->el && cell(col, row)->colspan <= 1 && (!m_fixed_layout || row == 0))
 			{
 				if (!cell(col, row)->el->src_el()->css().get_width().is_predefined() && m_columns[col].css_width.is_predefined())
 				{
@@ -126,6 +147,42 @@ void litehtml::table_grid::finish()
 		}
 	}
 
+	if(m_fixed_layout && m_rows_count)
+	{
+		// The width of the spanning cell in the first row is divided over the columns it spans
+		for(int col = 0; col < m_cols_count; col++)
+		{
+			table_cell* span_cell = cell(col, 0);
+			if(span_cell->el && span_cell->colspan > 1 && !span_cell->el->src_el()->css().get_width().is_predefined())
+			{
+				const css_length& cell_width = span_cell->el->src_el()->css().get_width();
+				int end = std::min(col + span_cell->colspan, m_cols_count);
+				int auto_count = 0;
+				// the widths already given to the spanned columns are subtracted from the cell width
+				float remaining = cell_width.val();
+				for(int span_col = col; span_col < end; span_col++)
+				{
+					const css_length& col_width = m_columns[span_col].css_width;
+					if(col_width.is_predefined())
+					{
+						auto_count++;
+					} else if(col_width.units() == cell_width.units())
+					{
+						remaining -= col_width.val();
+					}
+				}
+				remaining = std::max(remaining, 0.0f);
+				for(int span_col = col; span_col < end && auto_count; span_col++)
+				{
+					if(m_columns[span_col].css_width.is_predefined())
+					{
+						m_columns[span_col].css_width.set_value(remaining / (float) auto_count, cell_width.units());
+					}
+				}
+			}
+		}
+	}
+
 	for(int col = 0; col < m_cols_count; col++)
 	{
 		for(int row = 0; row < m_rows_count; row++)
@@ -147,6 +204,70 @@ litehtml::table_cell* litehtml::table_grid::cell( int t_col, int t_row )
 	return nullptr;
 }
 
+void litehtml::table_grid::calc_columns_min_max()
+{
+	// For each column, determine a maximum and minimum column width from the cells that span only that column.
+	// The minimum is that required by the cell with the largest minimum cell width (or the column 'width', whichever is
+	// larger).
+	// The maximum is that required by the cell with the largest maximum cell width (or the column 'width', whichever is
+	// larger).
+	// The cells are visited row by row in the storage order, so a long table is scanned in one linear pass.
+
+	for(auto& column : m_columns)
+	{
+		column.max_width = 0;
+		column.min_width = 0;
+	}
+	for(const auto& row : m_cells)
+	{
+		for(int col = 0; col < m_cols_count; col++)
+		{
+			const table_cell& cell = row[col];
+			if(cell.colspan <= 1)
+			{
+				m_columns[col].max_width = std::max(m_columns[col].max_width, cell.max_width);
+				m_columns[col].min_width = std::max(m_columns[col].min_width, cell.min_width);
+			}
+		}
+	}
+
+	if(!m_has_colspan)
+	{
+		return;
+	}
+
+	// For each cell that spans more than one column, increase the minimum widths of the columns it spans so that
+	// together,
+	// they are at least as wide as the cell. Do the same for the maximum widths.
+	// If possible, widen all spanned columns by approximately the same amount.
+
+	for(int col = 0; col < m_cols_count; col++)
+	{
+		for(int row = 0; row < m_rows_count; row++)
+		{
+			const table_cell& span_cell = m_cells[row][col];
+			if(span_cell.colspan > 1)
+			{
+				pixel_t max_total_width = m_columns[col].max_width;
+				pixel_t min_total_width = m_columns[col].min_width;
+				for(int col2 = col + 1; col2 < col + span_cell.colspan; col2++)
+				{
+					max_total_width += m_columns[col2].max_width;
+					min_total_width += m_columns[col2].min_width;
+				}
+				if(min_total_width < span_cell.min_width)
+				{
+					distribute_min_width(span_cell.min_width - min_total_width, col, col + span_cell.colspan - 1);
+				}
+				if(max_total_width < span_cell.max_width)
+				{
+					distribute_max_width(span_cell.max_width - max_total_width, col, col + span_cell.colspan - 1);
+				}
+			}
+		}
+	}
+}
+
 void litehtml::table_grid::distribute_max_width( pixel_t width, int start, int end )
 {
 	table_column_accessor_max_width selector;
@@ -408,13 +529,74 @@ litehtml::pixel_t litehtml::table_grid::calc_table_width(pixel_t block_width, bo
 	return cur_width;
 }
 
+litehtml::pixel_t litehtml::table_grid::calc_fixed_table_width(pixel_t block_width)
+{
+	// https://www.w3.org/TR/CSS22/tables.html#fixed-table-layout
+	// Columns with a specified width get it, the remaining columns divide the remaining space equally.
+	// If the table is wider than the columns, the extra space is distributed over all columns.
+	pixel_t cur_width = 0;
+	int auto_count = 0;
+
+	for(auto& column : m_columns)
+	{
+		if(!column.css_width.is_predefined())
+		{
+			column.width = std::max(column.css_width.calc_percent(block_width), (pixel_t) 0);
+			cur_width += column.width;
+		} else
+		{
+			column.width = 0;
+			auto_count++;
+		}
+	}
+
+	if(cur_width < block_width && m_cols_count)
+	{
+		pixel_t extra_width = block_width - cur_width;
+		if(auto_count)
+		{
+			pixel_t add = extra_width / (pixel_t) auto_count;
+			for(auto& column : m_columns)
+			{
+				if(column.css_width.is_predefined())
+				{
+					column.width = add;
+				}
+			}
+		} else
+		{
+			for(auto& column : m_columns)
+			{
+				if(cur_width != 0)
+				{
+					column.width += extra_width * (column.width / cur_width);
+				} else
+				{
+					column.width += extra_width / (pixel_t) m_cols_count;
+				}
+			}
+		}
+	}
+
+	cur_width = 0;
+	for(auto& column : m_columns)
+	{
+		column.min_width = column.max_width = column.width;
+		cur_width += column.width;
+	}
+	return cur_width;
+}
+
 void litehtml::table_grid::clear()
 {
 	m_rows_count	= 0;
 	m_cols_count	= 0;
 	m_cells.clear();
 	m_columns.clear();
+	m_columns_css_width.clear();
 	m_rows.clear();
+	m_has_colspan	= false;
+	m_has_rowspan	= false;
 }
 
 void litehtml::table_grid::calc_horizontal_positions( const margins& table_borders, border_collapse bc, pixel_t bdr_space_x)
@@ -608,3 +790,17 @@ litehtml::table_row::table_row(pixel_t h, const std::shared_ptr<render_item>& ro
 		css_height = row->src_el()->css().get_height();
 	}
 }
+
+size_t litehtml::table_grid::memory_usage() const
+{
+	size_t ret = m_cells.capacity() * sizeof(std::vector<table_cell>) +
+				 m_columns.capacity() * sizeof(table_column) +
+				 m_rows.capacity() * sizeof(table_row) +
+				 m_captions.capacity() * sizeof(std::shared_ptr<render_item>) +
+				 m_columns_css_width.capacity() * sizeof(css_length);
+	for(const auto& row : m_cells)
+	{
+		ret += row.capacity() * sizeof(table_cell);
+	}
+	return ret;
+}
@@ -0,0 +1,140 @@
+#include "thread_pool.h"
+
+#ifndef LITEHTML_NO_THREADS
+#include <algorithm>
+
+litehtml::thread_pool::thread_pool(int threads)
+{
+	for(int i = 0; i < threads; i++)
+	{
+		m_threads.emplace_back(&thread_pool::worker, this);
+	}
+}
+
+litehtml::thread_pool::~thread_pool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+	m_work_cv.notify_all();
+	for(auto& thread : m_threads)
+	{
+		thread.join();
+	}
+}
+
+void litehtml::thread_pool::parallel_for(size_t count, const std::function<void(size_t)>& func)
+{
+	if(m_threads.empty() || count < 2)
+	{
+		for(size_t i = 0; i < count; i++)
+		{
+			func(i);
+		}
+		return;
+	}
+
+	auto j = std::make_shared<job>();
+	j->func = &func;
+	j->count = count;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_jobs.push_back(j);
+	}
+	m_work_cv.notify_all();
+
+	// The calling thread works on its own job until all the indices are taken
+	while(run_one(*j)) {}
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_jobs.erase(std::remove(m_jobs.begin(), m_jobs.end(), j), m_jobs.end());
+	m_done_cv.wait(lock, [&j] { return j->done == j->count; });
+	lock.unlock();
+
+	if(j->error)
+	{
+		std::rethrow_exception(j->error);
+	}
+}
+
+void litehtml::thread_pool::worker()
+{
+	while(true)
+	{
+		std::shared_ptr<job> j;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_work_cv.wait(lock, [this, &j] {
+				if(m_stop) return true;
+				j = find_job();
+				return j != nullptr;
+			});
+			if(m_stop)
+			{
+				return;
+			}
+		}
+		while(run_one(*j)) {}
+	}
+}
+
+bool litehtml::thread_pool::run_one(job& j)
+{
+	size_t idx = j.next.fetch_add(1);
+	if(idx >= j.count)
+	{
+		return false;
+	}
+	try
+	{
+		(*j.func)(idx);
+	} catch(...)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if(!j.error)
+		{
+			j.error = std::current_exception();
+		}
+	}
+	if(j.done.fetch_add(1) + 1 == j.count)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_done_cv.notify_all();
+	}
+	return true;
+}
+
+std::shared_ptr<litehtml::thread_pool::job> litehtml::thread_pool::find_job() const
+{
+	// Prefer the most recent job: it is the innermost one of the nested calls, and finishing it
+	// unblocks the outer jobs sooner.
+	for(auto it = m_jobs.rbegin(); it != m_jobs.rend(); ++it)
+	{
+		if((*it)->next < (*it)->count)
+		{
+			return *it;
+		}
+	}
+	return nullptr;
+}
+
+#else
+
+litehtml::thread_pool::thread_pool(int /*threads*/)
+{
+}
+
+litehtml::thread_pool::~thread_pool()
+{
+}
+
+void litehtml::thread_pool::parallel_for(size_t count, const std::function<void(size_t)>& func)
+{
+	for(size_t i = 0; i < count; i++)
+	{
+		func(i);
+	}
+}
+
+#endif  // LITEHTML_NO_THREADS
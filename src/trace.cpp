@@ -0,0 +1,100 @@
+#include "trace.h"
+#include "element.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <ostream>
+
+namespace
+{
+	// Small sequential thread ids look better in the trace viewers than the hashes of std::thread::id
+	int thread_id()
+	{
+		static std::atomic<int> next_id {1};
+		thread_local int id = next_id++;
+		return id;
+	}
+
+	void append_json_string(litehtml::string& out, const char* str)
+	{
+		out += '"';
+		for(; *str; str++)
+		{
+			unsigned char ch = (unsigned char) *str;
+			if(ch == '"' || ch == '\\')
+			{
+				out += '\\';
+				out += (char) ch;
+			} else if(ch < 0x20)
+			{
+				char buf[8];
+				snprintf(buf, sizeof(buf), "\\u%04x", ch);
+				out += buf;
+			} else
+			{
+				out += (char) ch;
+			}
+		}
+		out += '"';
+	}
+
+	litehtml::string event_json(const char* name, char phase, litehtml::element* el)
+	{
+		auto ts = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
+		litehtml::string ret = "{\"name\":";
+		append_json_string(ret, name);
+		ret += ",\"cat\":\"litehtml\",\"ph\":\"";
+		ret += phase;
+		ret += "\",\"ts\":" + std::to_string(ts) + ",\"pid\":1,\"tid\":" + std::to_string(thread_id());
+		if(el)
+		{
+			ret += ",\"args\":{\"tag\":";
+			append_json_string(ret, el->get_tagName());
+			if(const char* id = el->get_attr("id"))
+			{
+				ret += ",\"id\":";
+				append_json_string(ret, id);
+			}
+			if(const char* cls = el->get_attr("class"))
+			{
+				ret += ",\"class\":";
+				append_json_string(ret, cls);
+			}
+			ret += "}";
+		}
+		ret += "}";
+		return ret;
+	}
+}
+
+litehtml::trace_stream_sink::~trace_stream_sink()
+{
+	m_out << (m_first ? "[]\n" : "\n]\n");
+	m_out.flush();
+}
+
+void litehtml::trace_stream_sink::add_event(const string& json)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_out << (m_first ? "[\n" : ",\n") << json;
+	m_first = false;
+}
+
+litehtml::trace_scope::trace_scope(trace_sink* sink, const char* name, element* el) :
+	m_sink(sink),
+	m_name(name)
+{
+	if(m_sink)
+	{
+		m_sink->add_event(event_json(m_name, 'B', el));
+	}
+}
+
+litehtml::trace_scope::~trace_scope()
+{
+	if(m_sink)
+	{
+		m_sink->add_event(event_json(m_name, 'E', nullptr));
+	}
+}
@@ -1,5 +1,6 @@
 #include "draw_buffer.h"
 #include "litehtml/types.h"
+#include <algorithm>
 
 /// @brief Scrolls draw buffer to the position (left, top).
 ///
@@ -20,67 +21,21 @@ void litebrowser::draw_buffer::on_scroll(const draw_page_function_t& cb_draw, in
 
 	if(m_left != left || m_top != top)
 	{
-		litehtml::position rec_current(m_left, m_top, m_width, m_height); // Current area
-		litehtml::position rec_new(left, top, m_width, m_height);		  // New area
-		litehtml::position rec_clean = rec_current.intersect(rec_new);	  // Clean area
-		if(rec_clean.empty() || rec_new == rec_current)
-		{
-			m_left = left;
-			m_top  = top;
-			redraw(cb_draw);
-		} else
-		{
-			int shift_x			 = m_left - left;
-			int shift_y			 = m_top - top;
-
-			int surface_shift_x	 = (int) std::floor((double) shift_x * m_scale_factor);
-			int surface_shift_y	 = (int) std::floor((double) shift_y * m_scale_factor);
-
-			auto	 new_surface = make_surface(m_width, m_height, m_scale_factor);
-			cairo_t* cr			 = cairo_create(new_surface);
-			cairo_rectangle(cr, (rec_clean.x - left) * m_scale_factor - m_scale_factor,
-							(rec_clean.y - top) * m_scale_factor - m_scale_factor,
-							std::ceil((double) rec_clean.width * m_scale_factor) + 2.0 * m_scale_factor,
-							std::ceil((double) rec_clean.height * m_scale_factor) + 2.0 * m_scale_factor);
-			cairo_clip(cr);
-			cairo_set_source_surface(cr, m_draw_buffer, surface_shift_x, surface_shift_y);
-			cairo_paint(cr);
-			cairo_destroy(cr);
-			cairo_surface_destroy(m_draw_buffer);
-			m_draw_buffer	 = new_surface;
-
-			m_left			 = left;
-			m_top			 = top;
-
-			int right		 = fix_position(m_left + m_width);
-			int bottom		 = fix_position(m_top + m_height);
-			int clean_right	 = fix_position(rec_clean.x + rec_clean.width);
-			int clean_bottom = fix_position(rec_clean.y + rec_clean.height);
-
-			if(rec_clean.x > m_left)
-			{
-				redraw_area(cb_draw, m_left, rec_clean.y, rec_clean.x - m_left, rec_clean.height);
-			}
-			if(clean_right < right)
-			{
-				redraw_area(cb_draw, clean_right, rec_clean.y, right - clean_right, rec_clean.height);
-			}
+		int shift_x = m_left - left;
+		int shift_y = m_top - top;
 
-			if(rec_clean.y > m_top)
-			{
-				redraw_area(cb_draw, m_left, m_top, m_width, rec_clean.y - m_top);
-			}
-			if(clean_bottom < bottom)
-			{
-				redraw_area(cb_draw, m_left, clean_bottom, m_width, bottom - clean_bottom);
-			}
+		m_left = left;
+		m_top  = top;
 
-			for(const auto& box : fixed_boxes)
-			{
-				redraw_area(cb_draw, m_left + box.left(), m_top + box.top(), box.width, box.height);
-				redraw_area(cb_draw, m_left + box.left() + shift_x, m_top + box.top() + shift_y, box.width, box.height);
-			}
+		// The tiles visible before keep the content, the fixed boxes are redrawn in the old and new positions
+		update_tiles();
+		for(const auto& box : fixed_boxes)
+		{
+			draw_area(cb_draw, fix_rect(m_left + box.left(), m_top + box.top(), box.width, box.height));
+			draw_area(cb_draw, fix_rect(m_left + box.left() + shift_x, m_top + box.top() + shift_y, box.width, box.height));
 		}
+		draw_invalid_tiles(cb_draw);
+		compose({0, 0, (litehtml::pixel_t) m_width, (litehtml::pixel_t) m_height});
 	}
 }
 
@@ -98,44 +53,191 @@ void litebrowser::draw_buffer::redraw_area(const draw_page_function_t& cb_draw,
 {
 	if(m_draw_buffer)
 	{
-		int fixed_left	 = fix_position(x - m_left);
-		int fixed_right	 = fix_position(x - m_left + width);
-		int fixed_top	 = fix_position(y - m_top);
-		int fixed_bottom = fix_position(y - m_top + height);
+		update_tiles();
+		litehtml::position pos = fix_rect(x, y, width, height);
+		draw_area(cb_draw, pos);
+		if(draw_invalid_tiles(cb_draw))
+		{
+			compose({0, 0, (litehtml::pixel_t) m_width, (litehtml::pixel_t) m_height});
+		} else
+		{
+			compose(pos);
+		}
+	}
+}
 
-		if(fixed_right < x + width)
-			fixed_right += m_min_int_position;
-		if(fixed_bottom < y + height)
-			fixed_bottom += m_min_int_position;
+void litebrowser::draw_buffer::clear_tiles()
+{
+	for(auto& t : m_tiles)
+	{
+		cairo_surface_destroy(t.surface);
+	}
+	m_tiles.clear();
+}
 
-		int fixed_x		 = fixed_left;
-		int fixed_y		 = fixed_top;
-		int fixed_width	 = fixed_right - fixed_left;
-		int fixed_height = fixed_bottom - fixed_top;
+/// @brief Makes the set of tiles covering the buffer at the current position
+///
+/// The tiles that are still visible are kept, the surfaces of the others are reused for the new tiles.
+/// New tiles are not valid and must be drawn.
+void litebrowser::draw_buffer::update_tiles()
+{
+	if(!m_draw_buffer)
+	{
+		clear_tiles();
+		return;
+	}
 
-		int s_x			 = (int) std::round((double) fixed_x * m_scale_factor);
-		int s_y			 = (int) std::round((double) fixed_y * m_scale_factor);
-		int s_width		 = (int) std::round((double) fixed_width * m_scale_factor);
-		int s_height	 = (int) std::round((double) fixed_height * m_scale_factor);
+	int col_first = floor_div(m_left, m_tile_size);
+	int col_last  = floor_div(m_left + m_width - 1, m_tile_size);
+	int row_first = floor_div(m_top, m_tile_size);
+	int row_last  = floor_div(m_top + m_height - 1, m_tile_size);
 
-		litehtml::position pos{(litehtml::pixel_t) fixed_x, (litehtml::pixel_t) fixed_y, (litehtml::pixel_t) fixed_width, (litehtml::pixel_t) fixed_height};
-		cairo_t*		   cr = cairo_create(m_draw_buffer);
+	std::vector<tile> tiles;
+	tiles.reserve((size_t) ((col_last - col_first + 1) * (row_last - row_first + 1)));
+	std::vector<cairo_surface_t*> spare;
+	for(auto& t : m_tiles)
+	{
+		if(t.col >= col_first && t.col <= col_last && t.row >= row_first && t.row <= row_last)
+		{
+			tiles.push_back(t);
+		} else
+		{
+			spare.push_back(t.surface);
+		}
+	}
 
-		// Apply clip with scaled position to avoid artifacts
-		cairo_rectangle(cr, s_x, s_y, s_width, s_height);
-		cairo_clip(cr);
+	size_t kept = tiles.size();
+	for(int row = row_first; row <= row_last; row++)
+	{
+		for(int col = col_first; col <= col_last; col++)
+		{
+			auto iter = std::find_if(tiles.begin(), tiles.begin() + (ptrdiff_t) kept,
+									 [row, col](const tile& t) { return t.row == row && t.col == col; });
+			if(iter != tiles.begin() + (ptrdiff_t) kept)
+			{
+				continue;
+			}
+			tile t;
+			t.col = col;
+			t.row = row;
+			if(!spare.empty())
+			{
+				t.surface = spare.back();
+				spare.pop_back();
+			} else
+			{
+				t.surface = make_surface(m_tile_size, m_tile_size, m_scale_factor);
+			}
+			tiles.push_back(t);
+		}
+	}
+
+	for(auto surface : spare)
+	{
+		cairo_surface_destroy(surface);
+	}
+	m_tiles = std::move(tiles);
+}
+
+/// @brief Converts the page rectangle to the buffer coordinates aligned according to the scale factor
+litehtml::position litebrowser::draw_buffer::fix_rect(int x, int y, int width, int height) const
+{
+	int fixed_left	 = fix_position(x - m_left);
+	int fixed_right	 = fix_position(x - m_left + width);
+	int fixed_top	 = fix_position(y - m_top);
+	int fixed_bottom = fix_position(y - m_top + height);
+
+	if(fixed_right < x + width)
+		fixed_right += m_min_int_position;
+	if(fixed_bottom < y + height)
+		fixed_bottom += m_min_int_position;
+
+	return {(litehtml::pixel_t) fixed_left, (litehtml::pixel_t) fixed_top,
+			(litehtml::pixel_t) (fixed_right - fixed_left), (litehtml::pixel_t) (fixed_bottom - fixed_top)};
+}
+
+/// @brief Draws the rectangle (buffer coordinates) into the valid tiles
+void litebrowser::draw_buffer::draw_area(const draw_page_function_t& cb_draw, const litehtml::position& rect)
+{
+	for(const auto& t : m_tiles)
+	{
+		if(t.valid)
+		{
+			draw_tile(cb_draw, t, rect);
+		}
+	}
+}
+
+/// @brief Draws the new tiles entirely
+/// @return true if any tile was drawn
+bool litebrowser::draw_buffer::draw_invalid_tiles(const draw_page_function_t& cb_draw)
+{
+	bool ret = false;
+	for(auto& t : m_tiles)
+	{
+		if(!t.valid)
+		{
+			draw_tile(cb_draw, t, tile_rect(t));
+			t.valid = true;
+			ret = true;
+		}
+	}
+	return ret;
+}
+
+/// @brief Draws the part of the rectangle (buffer coordinates) covered by the tile
+void litebrowser::draw_buffer::draw_tile(const draw_page_function_t& cb_draw, const tile& t, const litehtml::position& rect)
+{
+	litehtml::position tile_pos = tile_rect(t);
+	litehtml::position pos = tile_pos.intersect(rect);
+	if(pos.empty())
+	{
+		return;
+	}
+
+	int s_x		 = (int) std::round((double) pos.x * m_scale_factor);
+	int s_y		 = (int) std::round((double) pos.y * m_scale_factor);
+	int s_width	 = (int) std::round((double) pos.width * m_scale_factor);
+	int s_height = (int) std::round((double) pos.height * m_scale_factor);
 
-		// Clear rectangle with scaled position
-		cairo_rectangle(cr, s_x, s_y, s_width, s_height);
-		cairo_set_source_rgb(cr, 1.0, 1.0, 1.0);
-		cairo_fill(cr);
+	cairo_t* cr = cairo_create(t.surface);
 
-		// Apply scale for drawing
-		cairo_scale(cr, m_scale_factor, m_scale_factor);
+	// Draw in the buffer coordinates
+	cairo_translate(cr, -std::round((double) tile_pos.x * m_scale_factor), -std::round((double) tile_pos.y * m_scale_factor));
 
-		// Draw page
-		cb_draw(cr, -m_left, -m_top, &pos);
+	// Apply clip with scaled position to avoid artifacts
+	cairo_rectangle(cr, s_x, s_y, s_width, s_height);
+	cairo_clip(cr);
 
-		cairo_destroy(cr);
+	// Clear rectangle with scaled position
+	cairo_rectangle(cr, s_x, s_y, s_width, s_height);
+	cairo_set_source_rgb(cr, 1.0, 1.0, 1.0);
+	cairo_fill(cr);
+
+	// Apply scale for drawing
+	cairo_scale(cr, m_scale_factor, m_scale_factor);
+
+	// Draw page
+	cb_draw(cr, -m_left, -m_top, &pos);
+
+	cairo_destroy(cr);
+}
+
+/// @brief Copies the tiles into the rectangle (buffer coordinates) of the buffer surface
+void litebrowser::draw_buffer::compose(const litehtml::position& rect)
+{
+	cairo_t* cr = cairo_create(m_draw_buffer);
+	cairo_rectangle(cr, std::round((double) rect.x * m_scale_factor), std::round((double) rect.y * m_scale_factor),
+					std::round((double) rect.width * m_scale_factor), std::round((double) rect.height * m_scale_factor));
+	cairo_clip(cr);
+	for(const auto& t : m_tiles)
+	{
+		litehtml::position tile_pos = tile_rect(t);
+		if(!tile_pos.intersect(rect).empty())
+		{
+			cairo_set_source_surface(cr, t.surface, std::round((double) tile_pos.x * m_scale_factor), std::round((double) tile_pos.y * m_scale_factor));
+			cairo_paint(cr);
+		}
 	}
+	cairo_destroy(cr);
 }
@@ -5,6 +5,7 @@
 #include <functional>
 #include <cmath>
 #include <memory>
+#include <vector>
 #include "litehtml/types.h"
 
 namespace litebrowser
@@ -14,8 +15,22 @@ namespace litebrowser
 	/// This class performs the draw operations into the cairo surface.
 	/// The application draws everything to the buffer, then buffer is
 	/// drawn on widget or window.
+	///
+	/// The page is drawn into the fixed-size tiles aligned to the page coordinates, the buffer is composed
+	/// from the tiles. The tiles stay valid while they are visible, so scrolling draws the newly exposed
+	/// tiles and the fixed boxes only.
 	class draw_buffer
 	{
+		struct tile
+		{
+			int					col = 0;
+			int					row = 0;
+			cairo_surface_t*	surface = nullptr;
+			bool				valid = false;
+		};
+
+		static constexpr int tile_size_hint = 256;
+
 		cairo_surface_t*	m_draw_buffer = nullptr;
 		int					m_width = 0;
 		int					m_height = 0;
@@ -23,12 +38,19 @@ namespace litebrowser
 		int					m_left = 0;
 		double				m_scale_factor = 1;
 		int					m_min_int_position = 1;
+		int					m_tile_size = tile_size_hint;	// not scaled, multiple of m_min_int_position
+		std::vector<tile>	m_tiles;
 	public:
 
 		using draw_page_function_t = std::function<void(cairo_t* cr, int x, int y, const litehtml::position* clip)>;
 
+		draw_buffer() = default;
+		draw_buffer(const draw_buffer&) = delete;
+		draw_buffer& operator=(const draw_buffer&) = delete;
+
 		~draw_buffer()
 		{
+			clear_tiles();
 			if(m_draw_buffer)
 			{
 				cairo_surface_destroy(m_draw_buffer);
@@ -62,10 +84,12 @@ namespace litebrowser
 			{
 				m_scale_factor = scale;
 				m_min_int_position = get_denominator(m_scale_factor);
+				m_tile_size = (tile_size_hint + m_min_int_position - 1) / m_min_int_position * m_min_int_position;
 
 				m_top = fix_position(m_top);
 				m_left = fix_position(m_left);
 
+				clear_tiles();
 				if(m_draw_buffer)
 				{
 					cairo_surface_destroy(m_draw_buffer);
@@ -98,6 +122,7 @@ namespace litebrowser
 			{
 				m_width = width;
 				m_height = height;
+				clear_tiles();
 				if(m_draw_buffer)
 				{
 					cairo_surface_destroy(m_draw_buffer);
@@ -155,6 +180,24 @@ namespace litebrowser
 		}
 
 	private:
+		void clear_tiles();
+		void update_tiles();
+		[[nodiscard]] litehtml::position fix_rect(int x, int y, int width, int height) const;
+		void draw_area(const draw_page_function_t& cb_draw, const litehtml::position& rect);
+		bool draw_invalid_tiles(const draw_page_function_t& cb_draw);
+		void draw_tile(const draw_page_function_t& cb_draw, const tile& t, const litehtml::position& rect);
+		void compose(const litehtml::position& rect);
+		[[nodiscard]] litehtml::position tile_rect(const tile& t) const
+		{
+			return {(litehtml::pixel_t) (t.col * m_tile_size - m_left), (litehtml::pixel_t) (t.row * m_tile_size - m_top),
+					(litehtml::pixel_t) m_tile_size, (litehtml::pixel_t) m_tile_size};
+		}
+
+		static int floor_div(int a, int b)
+		{
+			return a >= 0 ? a / b : -((-a + b - 1) / b);
+		}
+
 		[[nodiscard]] int fix_position(int pos) const
 		{
 			return (pos / m_min_int_position) * m_min_int_position;
@@ -0,0 +1,76 @@
+// Draws HTML files with html2png::converter in the calling thread and in parallel bands and compares the images.
+//
+// Usage: draw_threads [-t threads] [-n repeats] file.html...
+//
+// Build it together with the cairo container, see support/README.md. Built with -fsanitize=thread it finds
+// the data races in the drawing functions of container_cairo_pango, decorations.html draws the underlined,
+// overlined and struck text over many bands.
+
+#include "render2png.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+int main(int argc, char* argv[])
+{
+	int threads = 3;
+	int repeats = 10;
+	int files = 0;
+	int failed = 0;
+
+	html2png::converter serial;
+	html2png::converter parallel;
+
+	for(int i = 1; i < argc; i++)
+	{
+		if(!strcmp(argv[i], "-t") && i + 1 < argc)
+		{
+			threads = atoi(argv[++i]);
+			continue;
+		}
+		if(!strcmp(argv[i], "-n") && i + 1 < argc)
+		{
+			repeats = atoi(argv[++i]);
+			continue;
+		}
+
+		const char* file = argv[i];
+		files++;
+		GdkPixbuf* expected = serial.to_pixbuf(file);
+		if(!expected)
+		{
+			printf("%s: can't draw the file\n", file);
+			failed++;
+			continue;
+		}
+
+		parallel.set_draw_threads(threads);
+		for(int n = 0; n < repeats; n++)
+		{
+			GdkPixbuf* pixbuf = parallel.to_pixbuf(file);
+			bool same = pixbuf && html2png::pngcmp(expected, pixbuf) == html2png::png_diff_same;
+			if(pixbuf)
+			{
+				g_object_unref(pixbuf);
+			}
+			if(!same)
+			{
+				printf("%s: the image drawn on %d threads differs from the serial one\n", file, threads);
+				failed++;
+				break;
+			}
+		}
+		g_object_unref(expected);
+	}
+
+	if(files == 0)
+	{
+		fprintf(stderr, "Usage: %s [-t threads] [-n repeats] file.html...\n", argv[0]);
+		return 1;
+	}
+	if(failed)
+	{
+		printf("%d of %d files failed\n", failed, files);
+	}
+	return failed ? 1 : 0;
+}
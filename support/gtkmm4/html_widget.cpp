@@ -6,6 +6,7 @@ html_widget::html_widget()
 	add_css_class("litehtml");
 
 	m_notifier = std::make_shared<html_widget_notifier>();
+	m_images = std::make_shared<cairo_images_cache>();
 	m_notifier->connect_redraw(sigc::mem_fun(*this, &html_widget::on_redraw));
 	m_notifier->connect_render(sigc::mem_fun(*this, &html_widget::render));
 	m_notifier->connect_update_state([this]() { m_sig_update_state.emit(get_state()); });
@@ -188,7 +189,7 @@ void html_widget::open_page(const litehtml::string& url, const litehtml::string&
 		{
 			m_current_page->stop_loading();
 		}
-		m_next_page = std::make_shared<litebrowser::web_page>(this, m_notifier, 10);
+		m_next_page = std::make_shared<litebrowser::web_page>(this, m_notifier, 10, m_images);
 		m_next_page->open(url, fragment);
 	}
 	m_sig_set_address.emit(url);
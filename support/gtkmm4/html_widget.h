@@ -211,6 +211,7 @@ class html_widget :		public Gtk::Widget,
 	std::shared_ptr<litebrowser::web_page> 	m_current_page;
 	std::shared_ptr<litebrowser::web_page> 	m_next_page;
 	std::shared_ptr<html_widget_notifier>	m_notifier;
+	std::shared_ptr<cairo_images_cache>		m_images;	// shared by the pages, so going back doesn't reload the images
 	web_history m_history;
 
 	Gtk::Scrollbar*	m_vscrollbar;
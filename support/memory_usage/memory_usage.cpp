@@ -0,0 +1,91 @@
+// Prints document::memory_usage() of the HTML files rendered with the test container.
+//
+// Usage: memory_usage [-w width] file.html...
+//
+// Build it together with the test container, see support/README.md
+
+#include "test_container.h"
+#include <cstdio>
+#include <cstring>
+
+string readfile(string filename);
+
+namespace
+{
+	const double kb = 1024.0;
+
+	void print_bytes(const char* name, size_t count, size_t bytes)
+	{
+		if(count)
+		{
+			printf("  %-16s %10zu %12.1f KB\n", name, count, (double) bytes / kb);
+		} else
+		{
+			printf("  %-16s %10s %12.1f KB\n", name, "", (double) bytes / kb);
+		}
+	}
+
+	void print_usage(const string& file, const litehtml::document_memory_usage& usage)
+	{
+		printf("%s\n", file.c_str());
+		print_bytes("elements", usage.elements, usage.element_bytes);
+		print_bytes("css_properties", 0, usage.css_properties_bytes);
+		print_bytes("styles", 0, usage.style_bytes);
+		print_bytes("used styles", 0, usage.used_styles_bytes);
+		print_bytes("rule tree", usage.rule_nodes, usage.rule_tree_bytes);
+		print_bytes("shared values", usage.shared_values, usage.shared_value_bytes);
+		print_bytes("render items", usage.render_items, usage.render_item_bytes);
+		print_bytes("line boxes", usage.line_boxes, usage.line_box_bytes);
+		print_bytes("stylesheets", usage.selectors, usage.stylesheet_bytes);
+		print_bytes("fonts", usage.fonts, usage.font_bytes);
+		print_bytes("total", 0, usage.total_bytes());
+		print_bytes("string ids", usage.string_ids, usage.string_id_bytes);
+
+		printf("  element counts:");
+		for(const auto& item : usage.element_counts)
+		{
+			printf(" %s=%zu", item.first.c_str(), item.second);
+		}
+		printf("\n\n");
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	int width = 800;
+	size_t total = 0;
+	int files = 0;
+
+	for(int i = 1; i < argc; i++)
+	{
+		if(!strcmp(argv[i], "-w") && i + 1 < argc)
+		{
+			width = atoi(argv[++i]);
+			continue;
+		}
+
+		string file = argv[i];
+		string html = readfile(file);
+		string basedir = file.substr(0, file.find_last_of("/\\") + 1);
+
+		test_container container(width, 600, basedir);
+		auto doc = document::createFromString(html, &container);
+		doc->render((pixel_t) width);
+
+		auto usage = doc->memory_usage();
+		print_usage(file, usage);
+		total += usage.total_bytes();
+		files++;
+	}
+
+	if(files == 0)
+	{
+		fprintf(stderr, "Usage: %s [-w width] file.html...\n", argv[0]);
+		return 1;
+	}
+	if(files > 1)
+	{
+		printf("%d documents, %.1f KB in total, %.1f KB on average\n", files, (double) total / kb, (double) total / kb / files);
+	}
+	return 0;
+}
@@ -0,0 +1,114 @@
+// Parses, renders and draws HTML files with the test container on several threads at the same time.
+//
+// Usage: thread_stress [-t threads] [-n repeats] [-l layout_threads] [-w width] file.html...
+//
+// Every thread creates own containers and documents, so the threads share only the global state of
+// litehtml: the string ids, the font registry and the fonts. The image of every document must match the
+// one drawn on the main thread before. Build it with -fsanitize=thread to find the data races, see
+// support/README.md
+
+#include "test_container.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+string readfile(string filename);
+
+namespace
+{
+	struct page
+	{
+		string	file;
+		string	html;
+		Bitmap	expected;
+	};
+
+	Bitmap draw_page(const page& pg, int width, int layout_threads)
+	{
+		string basedir = pg.file.substr(0, pg.file.find_last_of("/\\") + 1);
+		test_container container(width, 600, basedir);
+		auto doc = document::createFromString(pg.html, &container);
+		doc->set_layout_threads(layout_threads);
+		doc->render((pixel_t) width);
+
+		int height = std::max(1, (int) doc->height());
+		canvas cvs(width, height);
+		cvs.set_color(fill_style, 1, 1, 1, 1);
+		cvs.fill_rectangle(0, 0, (float) width, (float) height);
+		position clip(0, 0, width, height);
+		doc->draw((uint_ptr) &cvs, 0, 0, &clip);
+		return Bitmap(cvs);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	int threads = 4;
+	int repeats = 5;
+	int layout_threads = 0;
+	int width = 800;
+	std::vector<page> pages;
+
+	for(int i = 1; i < argc; i++)
+	{
+		if(!strcmp(argv[i], "-t") && i + 1 < argc)
+		{
+			threads = atoi(argv[++i]);
+		} else if(!strcmp(argv[i], "-n") && i + 1 < argc)
+		{
+			repeats = atoi(argv[++i]);
+		} else if(!strcmp(argv[i], "-l") && i + 1 < argc)
+		{
+			layout_threads = atoi(argv[++i]);
+		} else if(!strcmp(argv[i], "-w") && i + 1 < argc)
+		{
+			width = atoi(argv[++i]);
+		} else
+		{
+			pages.push_back({argv[i], readfile(argv[i]), {}});
+		}
+	}
+
+	if(pages.empty() || threads < 1)
+	{
+		fprintf(stderr, "Usage: %s [-t threads] [-n repeats] [-l layout_threads] [-w width] file.html...\n", argv[0]);
+		return 1;
+	}
+
+	for(auto& pg : pages)
+	{
+		pg.expected = draw_page(pg, width, 0);
+	}
+
+	// The threads start at different pages, so different documents are processed at the same time
+	std::atomic<int> failed {0};
+	std::vector<std::thread> workers;
+	for(int t = 0; t < threads; t++)
+	{
+		workers.emplace_back([&, t]
+			{
+				for(int n = 0; n < repeats; n++)
+				{
+					for(size_t i = 0; i < pages.size(); i++)
+					{
+						const page& pg = pages[(i + t) % pages.size()];
+						if(draw_page(pg, width, layout_threads) != pg.expected)
+						{
+							printf("%s: the image drawn on the thread %d differs\n", pg.file.c_str(), t);
+							failed++;
+						}
+					}
+				}
+			});
+	}
+	for(auto& worker : workers)
+	{
+		worker.join();
+	}
+
+	printf("%d threads, %d documents: %d failed\n", threads, threads * repeats * (int) pages.size(), failed.load());
+	return failed ? 1 : 0;
+}
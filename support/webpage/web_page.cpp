@@ -114,7 +114,7 @@ void litebrowser::web_page::set_base_url(const char* base_url)
 
 cairo_surface_t* litebrowser::web_page::get_image(const std::string& url)
 {
-	return m_images.get_image(url);
+	return m_images->get_image(url);
 }
 
 void litebrowser::web_page::show_fragment(const litehtml::string& fragment)
@@ -237,20 +237,26 @@ void litebrowser::web_page::on_image_downloaded(std::shared_ptr<image_file> data
 												const std::string& /*url*/)
 {
 	data->close();
+	cairo_surface_t* ptr = nullptr;
 	if(!data->path().empty() && !err_code && (http_status == 200 || http_status == 0))
 	{
-		auto ptr = m_html_host->load_image(data->path());
-		if(ptr)
+		ptr = m_html_host->load_image(data->path());
+	}
+	if(ptr)
+	{
+		// The images are used by the page until it is closed
+		m_images->add_image(data->url(), ptr, this);
+		if(data->redraw_only())
 		{
-			m_images.add_image(data->url(), ptr);
-			if(data->redraw_only())
-			{
-				m_notify->redraw();
-			} else
-			{
-				m_notify->render();
-			}
+			m_notify->redraw();
+		} else
+		{
+			m_notify->render();
 		}
+	} else
+	{
+		// Remove the empty record, so the image is requested again next time
+		m_images->cancel(data->url(), this);
 	}
 	unlink(data->path().c_str());
 }
@@ -260,7 +266,9 @@ void litebrowser::web_page::load_image(const char *src, const char *baseurl, boo
 	std::string url;
 	make_url(src, baseurl, url);
 
-	if(m_images.reserve(url))
+	// The image is pinned by the page. It is downloaded unless it is loaded already or this page requested it,
+	// another page sharing the cache and downloading it doesn't redraw this one.
+	if(m_images->reserve(url, this))
 	{
 		auto data = std::make_shared<image_file>(url, redraw_on_ready);
 		auto cb_on_data = [data](void* in_data, size_t len, size_t /*downloaded*/, size_t /*total*/) { data->on_data(in_data, len, 0, 0); };
@@ -10,6 +10,7 @@
 #include "http_requests_pool.h"
 #include "cairo_images_cache.h"
 #include "litehtml/types.h"
+#include "litehtml/thread_pool.h"
 
 namespace litebrowser
 {
@@ -72,19 +73,27 @@ namespace litebrowser
 		litehtml::string				m_clicked_url;
 		std::string                 	m_fragment;
 		html_host_interface*			m_html_host;
-		cairo_images_cache				m_images;
+		std::shared_ptr<cairo_images_cache>	m_images;
 		litebrowser::http_requests_pool	m_requests_pool;
 		std::string 					m_html_source;
+		std::unique_ptr<litehtml::thread_pool>	m_draw_pool;
 
 		std::shared_ptr<browser_notify_interface> m_notify;
 
 	public:
-		explicit web_page(html_host_interface* html_host, std::shared_ptr<browser_notify_interface> notify, int pool_size) :
+		// The images cache can be shared by the pages, the page pins its images until it is destroyed
+		explicit web_page(html_host_interface* html_host, std::shared_ptr<browser_notify_interface> notify, int pool_size, std::shared_ptr<cairo_images_cache> images = nullptr) :
 				m_html_host(html_host),
+				m_images(images ? std::move(images) : std::make_shared<cairo_images_cache>()),
 				m_requests_pool(pool_size, [this] { on_pool_update_state(); }),
 				m_notify(std::move(notify))
 		{}
 
+		~web_page() override
+		{
+			m_images->unpin(this);
+		}
+
 		[[nodiscard]]
 		uint64_t id() const { return (uint64_t)this; }
 
@@ -127,7 +136,21 @@ namespace litebrowser
 		void draw(litehtml::uint_ptr hdc, int x, int y, const litehtml::position* clip)
 		{
 			std::lock_guard<std::recursive_mutex> html_lock(m_html_mutex);
-			if(m_html) m_html->draw(hdc, x, y, clip);
+			if(!m_html) return;
+			if(m_draw_pool && clip)
+			{
+				draw_tiled(m_html, (cairo_t*) hdc, x, y, *clip, m_draw_pool.get());
+			} else
+			{
+				m_html->draw(hdc, x, y, clip);
+			}
+		}
+
+		// Number of additional threads used to draw the page, 0 to draw in the calling thread only
+		void set_draw_threads(int threads)
+		{
+			std::lock_guard<std::recursive_mutex> html_lock(m_html_mutex);
+			m_draw_pool = threads > 0 ? std::make_unique<litehtml::thread_pool>(threads) : nullptr;
 		}
 
 		int render(int max_width)
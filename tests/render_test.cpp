@@ -0,0 +1,207 @@
+// Renders the reference pages with the test container and compares them with the expected images.
+//
+// Usage: render_test [-t threads] [-m x,y]... [-l step] [-u] page.htm...
+//
+//   -t threads  lay the pages out serially and on the given number of threads, both must match
+//   -m x,y      move the mouse to (x, y) after drawing and redraw only the damaged boxes, the result
+//               must match the page drawn at once; the option can be repeated
+//   -l step     lay the pages out with render_lazy and draw them in bands of step pixels from the top,
+//               the layout continues in draw() and the result must match the page laid out at once
+//   -u          write page.htm.png instead of comparing the page with it
+//
+// See tests/README.md
+
+#include "test_container.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+string readfile(string filename);
+
+namespace
+{
+	const int page_width = 800;
+
+	using mouse_moves = std::vector<std::pair<int, int>>;
+
+	// Draws the document inside the box over the previous drawing, the way a window repaints the damaged area
+	void draw_box(const document::ptr& doc, canvas& cvs, const position& box)
+	{
+		float left = std::floor(box.left());
+		float top = std::floor(box.top());
+		float right = std::ceil(box.right());
+		float bottom = std::ceil(box.bottom());
+
+		cvs.save();
+		cvs.begin_path();
+		cvs.rectangle(left, top, right - left, bottom - top);
+		cvs.clip();
+		cvs.set_color(fill_style, 1, 1, 1, 1);
+		cvs.fill_rectangle(left, top, right - left, bottom - top);
+		position clip(left, top, right - left, bottom - top);
+		doc->draw((uint_ptr) &cvs, 0, 0, &clip);
+		cvs.restore();
+	}
+
+	// With redraw_damage the page is drawn before every mouse move and then only the damaged boxes
+	// are redrawn, otherwise it is drawn once after all the moves.
+	Bitmap render_page(const string& file, const string& html, int threads, const mouse_moves& moves, bool redraw_damage)
+	{
+		string basedir = file.substr(0, file.find_last_of("/\\") + 1);
+		test_container container(page_width, 600, basedir);
+		auto doc = document::createFromString(html, &container);
+		doc->set_layout_threads(threads);
+		doc->render(page_width);
+
+		int height = std::max(1, (int) doc->height());
+		canvas cvs(page_width, height);
+		position page(0, 0, page_width, height);
+		if(redraw_damage)
+		{
+			draw_box(doc, cvs, page);
+		}
+		for(const auto& move : moves)
+		{
+			damage_region damage;
+			if(doc->on_mouse_over(move.first, move.second, move.first, move.second, damage) && redraw_damage)
+			{
+				for(const auto& box : damage.rects())
+				{
+					draw_box(doc, cvs, box);
+				}
+			}
+		}
+		if(!redraw_damage)
+		{
+			draw_box(doc, cvs, page);
+		}
+		return Bitmap(cvs);
+	}
+
+	// Draws the page in bands from the top, draw() continues the lazy layout for every band. Every band
+	// is drawn once, so the result matches the page laid out at once only if the layout above the
+	// bands already drawn doesn't change when it continues.
+	Bitmap render_page_lazy(const string& file, const string& html, int step, int height)
+	{
+		string basedir = file.substr(0, file.find_last_of("/\\") + 1);
+		test_container container(page_width, 600, basedir);
+		auto doc = document::createFromString(html, &container);
+		doc->render(page_width, render_lazy);
+
+		canvas cvs(page_width, height);
+		for(int top = 0; top < (int) doc->height() && top < height; top += step)
+		{
+			draw_box(doc, cvs, position(0, (pixel_t) top, page_width, (pixel_t) step));
+		}
+		if((int) doc->height() != height)
+		{
+			return Bitmap(page_width, std::max(1, (int) doc->height()));
+		}
+		return Bitmap(cvs);
+	}
+
+	bool test_page(const string& file, int threads, const mouse_moves& moves, int lazy_step, bool update)
+	{
+		string html = readfile(file);
+		if(html.empty())
+		{
+			printf("%s: can't read the page\n", file.c_str());
+			return false;
+		}
+
+		Bitmap bmp = render_page(file, html, 0, moves, false);
+		if(threads > 0 && render_page(file, html, threads, moves, false) != bmp)
+		{
+			printf("%s: the parallel layout differs from the serial one\n", file.c_str());
+			return false;
+		}
+		if(!moves.empty() && render_page(file, html, threads, moves, true) != bmp)
+		{
+			printf("%s: the redrawn damage doesn't cover all the changes\n", file.c_str());
+			return false;
+		}
+		if(lazy_step > 0 && render_page_lazy(file, html, lazy_step, bmp.height) != bmp)
+		{
+			printf("%s: the lazy layout differs from the layout at once\n", file.c_str());
+			return false;
+		}
+
+		string png = file + ".png";
+		if(update)
+		{
+			bmp.save(png);
+			return true;
+		}
+		Bitmap expected(png);
+		if(!expected)
+		{
+			printf("%s: can't load %s\n", file.c_str(), png.c_str());
+			return false;
+		}
+		if(bmp != expected)
+		{
+			bmp.save(file + "-FAILED.png");
+			printf("%s: the page differs from %s\n", file.c_str(), png.c_str());
+			return false;
+		}
+		return true;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	int threads = 0;
+	mouse_moves moves;
+	int lazy_step = 0;
+	bool update = false;
+	int pages = 0;
+	int failed = 0;
+
+	for(int i = 1; i < argc; i++)
+	{
+		if(!strcmp(argv[i], "-t") && i + 1 < argc)
+		{
+			threads = atoi(argv[++i]);
+			continue;
+		}
+		if(!strcmp(argv[i], "-m") && i + 1 < argc)
+		{
+			int x = 0;
+			int y = 0;
+			if(sscanf(argv[++i], "%d,%d", &x, &y) == 2)
+			{
+				moves.emplace_back(x, y);
+			}
+			continue;
+		}
+		if(!strcmp(argv[i], "-l") && i + 1 < argc)
+		{
+			lazy_step = atoi(argv[++i]);
+			continue;
+		}
+		if(!strcmp(argv[i], "-u"))
+		{
+			update = true;
+			continue;
+		}
+
+		if(!test_page(argv[i], threads, moves, lazy_step, update))
+		{
+			failed++;
+		}
+		pages++;
+	}
+
+	if(pages == 0)
+	{
+		fprintf(stderr, "Usage: %s [-t threads] [-m x,y]... [-l step] [-u] page.htm...\n", argv[0]);
+		return 1;
+	}
+	if(failed)
+	{
+		printf("%d of %d pages failed\n", failed, pages);
+	}
+	return failed ? 1 : 0;
+}